@@ -0,0 +1,355 @@
+#include "eye_bench.h"
+
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "eye_controller.h"
+#include "eye_frame_sched.h"
+#include "eye_loop.h"
+#include "eye_tick.h"
+#include "lib/fbdev_display.h"
+#include "lvgl.h"
+
+#define BENCH_RES 240          // px，与真实面板一致
+#define BENCH_FRAMES 300       // 每个场景每种分块数渲染的帧数
+#define BENCH_WARMUP_FRAMES 20 // 预热帧（GIF 首帧解码等）不计入统计
+#define BENCH_POWER_MS 3000    // 功耗场景每种情况运行的时长
+#define BENCH_IDLE_PERIOD_US 50000  // 自适应模式的空闲帧周期
+#define BENCH_GAZE_CMD_MS 100  // 活动场景中视线命令的间隔
+#define BENCH_FB_FILE "/tmp/eye_bench_fb"  // 模拟 deferred I/O 面板的文件
+
+/* 渲染耗时统计（由显示器事件累加，与触发渲染的位置无关） */
+typedef struct {
+  uint64_t render_start_us;
+  uint64_t render_total_us;
+  uint32_t render_cnt;
+} bench_stat_t;
+
+static bench_stat_t g_stats[EYE_MAX_CNT];
+
+static void bench_render_event_cb(lv_event_t *e) {
+  bench_stat_t *stat = lv_event_get_user_data(e);
+  if (lv_event_get_code(e) == LV_EVENT_RENDER_START) {
+    stat->render_start_us = eye_tick_us();
+  } else {
+    stat->render_total_us += eye_tick_us() - stat->render_start_us;
+    stat->render_cnt++;
+  }
+}
+
+/* 第 idx 只眼睛：内存显示器，左右眼素材交替使用 */
+static eye_config_t bench_eye_config(const eye_bench_assets_t *assets,
+                                     uint32_t idx) {
+  eye_config_t cfg = {
+      .panel =
+          {
+              .type = EYE_PANEL_MEMORY,
+              .hor_res = BENCH_RES,
+              .ver_res = BENCH_RES,
+              .color_format = LV_COLOR_FORMAT_RGB565,
+          },
+      .eye_path = idx % 2 ? assets->right_eye_path : assets->left_eye_path,
+      .eyelid_path =
+          idx % 2 ? assets->right_eyelid_path : assets->left_eyelid_path,
+      .max_offset_px = assets->max_offset_px,
+  };
+  return cfg;
+}
+
+static lv_display_t *bench_display_create(const eye_panel_config_t *panel,
+                                          bench_stat_t *stat) {
+  lv_display_t *disp = eye_panel_create(panel);
+  if (!disp) return NULL;
+  lv_display_add_event_cb(disp, bench_render_event_cb, LV_EVENT_RENDER_START,
+                          stat);
+  lv_display_add_event_cb(disp, bench_render_event_cb, LV_EVENT_RENDER_READY,
+                          stat);
+  return disp;
+}
+
+/* 沿圆周移动视线，保证每帧眼球区域都失效重绘 */
+static void bench_move_gaze(struct eye_t *eye, uint32_t frame) {
+  int16_t angle = (int16_t)((frame * 7) % 360);
+  int32_t r = eye->max_offset;
+  int32_t x = (lv_trigo_cos(angle) * r) >> 15;
+  int32_t y = (lv_trigo_sin(angle) * r) >> 15;
+  lv_obj_set_style_translate_x(eye->eye_gif, x, 0);
+  lv_obj_set_style_translate_y(eye->eye_gif, y, 0);
+}
+
+/* 返回每只眼平均每帧渲染耗时（us），frame_us 返回所有眼睛一帧的总耗时 */
+static uint32_t bench_run_scene(struct eye_t *const *eyes, uint32_t eye_cnt,
+                                uint32_t tile_cnt, uint32_t *frame_us) {
+  uint64_t start_us = 0;
+
+  eye_controller_set_render_tiles(tile_cnt);
+
+  for (uint32_t i = 0; i < BENCH_FRAMES + BENCH_WARMUP_FRAMES; i++) {
+    if (i == BENCH_WARMUP_FRAMES) {
+      for (uint32_t e = 0; e < eye_cnt; e++) g_stats[e] = (bench_stat_t){0};
+      start_us = eye_tick_us();
+    }
+    for (uint32_t e = 0; e < eye_cnt; e++) bench_move_gaze(eyes[e], i);
+    lv_timer_handler();  // 推进 GIF 帧
+    lv_refr_now(NULL);
+  }
+  if (frame_us) *frame_us = (uint32_t)((eye_tick_us() - start_us) / BENCH_FRAMES);
+
+  uint64_t total_us = 0;
+  uint32_t cnt = 0;
+  for (uint32_t e = 0; e < eye_cnt; e++) {
+    total_us += g_stats[e].render_total_us;
+    cnt += g_stats[e].render_cnt;
+  }
+  if (cnt == 0) return 0;
+  return (uint32_t)(total_us / cnt);
+}
+
+typedef struct {
+  const char *name;
+  bool blink;        // 眼皮循环播放
+  bool layer_cache;  // 眼皮静止时使用预合成图层
+} bench_scene_t;
+
+static void bench_prepare_eye(struct eye_t *eye, const bench_scene_t *scene) {
+  eye_layer_cache_set_enabled(&eye->layer_cache, scene->layer_cache);
+  // 眼皮挂到本眼的时钟上，restart 会立即切回第一帧
+  eye_gif_player_attach(eye->eyelid_gif, &eye->lid_clock);
+  eye_gif_player_set_loop_count(eye->eyelid_gif, scene->blink ? -1 : 1);
+  eye_anim_clock_restart(&eye->lid_clock);
+  if (scene->blink) {
+    eye_layer_cache_invalidate(&eye->layer_cache);
+  } else {
+    eye_anim_clock_pause(&eye->lid_clock);
+    eye_layer_cache_build(&eye->layer_cache);
+  }
+}
+
+typedef struct {
+  const char *name;
+  bool gaze;                // 周期性发送视线命令
+  uint32_t idle_period_us;  // 0 表示关闭自适应
+} bench_power_t;
+
+static uint64_t bench_cpu_us(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);  // 包含绘制线程
+  return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+/* 模拟上位机：每隔一段时间沿圆周发一次视线命令 */
+static void bench_gaze_cmd_cb(lv_timer_t *timer) {
+  struct eye_t **eyes = lv_timer_get_user_data(timer);
+  static uint32_t step;
+  int16_t angle = (int16_t)((step++ * 37) % 360);
+  int32_t r = eyes[0]->max_offset;
+  int32_t x = (lv_trigo_cos(angle) * r) >> 15;
+  int32_t y = (lv_trigo_sin(angle) * r) >> 15;
+  eye_look_at(eyes[0], x, y);
+  eye_look_at(eyes[1], x, y);
+}
+
+/* 用真实主循环（帧调度 + 事件循环）运行一段时间，统计 CPU 占用和唤醒次数 */
+static void bench_run_power(struct eye_t **eyes, const bench_power_t *p) {
+  lv_timer_t *cmd_timer = NULL;
+  if (p->gaze) {
+    cmd_timer = lv_timer_create(bench_gaze_cmd_cb, BENCH_GAZE_CMD_MS, eyes);
+  }
+
+  eye_frame_sched_set_idle_period(p->idle_period_us);
+
+  eye_loop_stats_t loop;
+  eye_frame_stats_t fl, fr;
+  eye_loop_get_stats(&loop, true);
+  eye_frame_sched_get_stats(0, &fl, true);
+  eye_frame_sched_get_stats(1, &fr, true);
+
+  uint64_t wall_start = eye_tick_us();
+  uint64_t cpu_start = bench_cpu_us();
+  while (eye_tick_us() - wall_start < BENCH_POWER_MS * 1000ull) {
+    eye_controller_process_commands();
+    eye_loop_wait_us(eye_frame_sched_handler());
+  }
+  uint64_t wall = eye_tick_us() - wall_start;
+  uint64_t cpu = bench_cpu_us() - cpu_start;
+
+  eye_loop_get_stats(&loop, true);
+  eye_frame_sched_get_stats(0, &fl, true);
+  eye_frame_sched_get_stats(1, &fr, true);
+  if (cmd_timer) lv_timer_delete(cmd_timer);
+
+  printf("%-12s %9s %7.1f%% %10.1f %8.1f\n", p->name,
+         p->idle_period_us ? "on" : "off", cpu * 100.0 / wall,
+         loop.wait_cnt * 1000000.0 / wall,
+         (fl.frame_cnt + fr.frame_cnt) * 500000.0 / wall);
+}
+
+/* 在 eye_cnt 个显示器上初始化眼睛，眼皮停止定时眨眼
+ * panel 为 NULL 时使用内存显示器 */
+static bool bench_setup_eyes(const eye_bench_assets_t *assets,
+                             const eye_panel_config_t *panel,
+                             struct eye_t *const *eyes, uint32_t eye_cnt,
+                             lv_display_t **disps) {
+  eye_config_t cfgs[EYE_MAX_CNT];
+
+  lv_init();
+  lv_tick_set_cb(eye_tick_ms);
+
+  for (uint32_t i = 0; i < eye_cnt; i++) {
+    cfgs[i] = bench_eye_config(assets, i);
+    if (panel) cfgs[i].panel = *panel;
+    disps[i] = bench_display_create(&cfgs[i].panel, &g_stats[i]);
+    if (!disps[i]) {
+      printf("eye bench: failed to create display %u\n", i);
+      lv_deinit();
+      return false;
+    }
+  }
+
+  eye_controller_init_with_displays(disps, eyes, cfgs, eye_cnt);
+  eyelid_blink(0, 0);  // 关闭定时眨眼，由场景自行控制眼皮
+  eye_controller_set_idle_gaze(false, NULL);  // 视线也只由场景控制
+  eye_controller_process_commands();  // 场景不经过主循环，命令要在这里执行
+  lv_timer_handler();
+  return true;
+}
+
+/* 眼睛数从 1 增加到 EYE_MAX_CNT：一帧总耗时如何随面板数增长 */
+static void bench_run_scaling(const eye_bench_assets_t *assets) {
+  static const bench_scene_t still = {"still", false, true};
+  struct eye_t eye_objs[EYE_MAX_CNT];
+  struct eye_t *eyes[EYE_MAX_CNT];
+  lv_display_t *disps[EYE_MAX_CNT];
+  uint32_t base_us = 0;
+
+  for (uint32_t i = 0; i < EYE_MAX_CNT; i++) eyes[i] = &eye_objs[i];
+
+  printf("\n%-6s %12s %10s %10s %8s\n", "eyes", "us/frame", "us/eye",
+         "max fps", "scale");
+  for (uint32_t n = 1; n <= EYE_MAX_CNT; n++) {
+    if (!bench_setup_eyes(assets, NULL, eyes, n, disps)) return;
+    for (uint32_t i = 0; i < n; i++) bench_prepare_eye(eyes[i], &still);
+
+    uint32_t frame_us = 0;
+    uint32_t eye_us = bench_run_scene(eyes, n, 0, &frame_us);
+    if (n == 1) base_us = frame_us;
+    printf("%-6u %12u %10u %10.1f %7.2fx\n", n, frame_us, eye_us,
+           frame_us ? 1000000.0 / frame_us : 0.0,
+           base_us ? (double)frame_us / base_us : 0.0);
+
+    eye_controller_deinit();
+  }
+}
+
+/* 文件模拟的 fbdev 面板：比较只写变化像素前后每帧写入的字节数和内存页数 */
+static void bench_run_deferred_io(const eye_bench_assets_t *assets) {
+  static const bench_scene_t still = {"still", false, true};
+  struct eye_t eye;
+  struct eye_t *eyes[] = {&eye};
+  lv_display_t *disp;
+
+  printf("\n%-12s %10s %12s %12s %10s\n", "deferred-io", "us/frame",
+         "B/frame", "skipped B", "pages");
+  for (uint32_t on = 0; on <= 1; on++) {
+    eye_panel_config_t panel = {
+        .type = EYE_PANEL_FBDEV,
+        .path = BENCH_FB_FILE,
+        .hor_res = BENCH_RES,
+        .ver_res = BENCH_RES,
+        .color_format = LV_COLOR_FORMAT_RGB565,
+        .buf_strategy = EYE_BUF_COPY,
+        .deferred_io = on,
+    };
+    FILE *f = fopen(BENCH_FB_FILE, "w");  // 每次从全黑的文件开始
+    if (!f) {
+      printf("eye bench: cannot create %s\n", BENCH_FB_FILE);
+      return;
+    }
+    fclose(f);
+
+    if (!bench_setup_eyes(assets, &panel, eyes, 1, &disp)) break;
+    bench_prepare_eye(&eye, &still);
+
+    fbdev_display_stats_t st;
+    uint32_t frame_us = 0;
+    fbdev_display_get_stats(disp, &st, true);
+    bench_run_scene(eyes, 1, 0, &frame_us);
+    fbdev_display_get_stats(disp, &st, true);
+    if (st.frame_cnt > 0) {
+      printf("%-12s %10u %12llu %12llu %10.1f\n", on ? "on" : "off", frame_us,
+             (unsigned long long)(st.bytes_written / st.frame_cnt),
+             (unsigned long long)(st.bytes_skipped / st.frame_cnt),
+             (double)st.pages_written / st.frame_cnt);
+    }
+
+    eye_controller_deinit();
+  }
+  unlink(BENCH_FB_FILE);
+}
+
+int eye_bench_run(const eye_bench_assets_t *assets) {
+  static const uint32_t tiles[] = {1, 2, 4};
+  static const bench_scene_t scenes[] = {
+      {"gaze", false, true},
+      {"gaze-nocache", false, false},
+      {"gaze+blink", true, false},
+  };
+  struct eye_t left_eye, right_eye;
+  struct eye_t *eyes[] = {&left_eye, &right_eye};
+  lv_display_t *disps[2];
+
+  if (!bench_setup_eyes(assets, NULL, eyes, 2, disps)) return 1;
+
+  printf("eye bench: %dx%d x2, draw units %d, online cpus %ld, %d frames\n",
+         BENCH_RES, BENCH_RES, LV_DRAW_SW_DRAW_UNIT_CNT,
+         sysconf(_SC_NPROCESSORS_ONLN), BENCH_FRAMES);
+  // 绘制单元数在编译时固定，这里用分块数代替：同时渲染的单元数是两者中较小的
+  printf("%-12s %6s %6s %12s %8s\n", "scene", "tiles", "units", "us/frame",
+         "speedup");
+
+  for (uint32_t s = 0; s < sizeof(scenes) / sizeof(scenes[0]); s++) {
+    uint32_t base_us = 0;
+
+    for (uint32_t t = 0; t < sizeof(tiles) / sizeof(tiles[0]); t++) {
+      bench_prepare_eye(&left_eye, &scenes[s]);
+      bench_prepare_eye(&right_eye, &scenes[s]);
+
+      uint32_t us = bench_run_scene(eyes, 2, tiles[t], NULL);
+      if (t == 0) base_us = us;
+      uint32_t units = LV_MIN(tiles[t], (uint32_t)LV_DRAW_SW_DRAW_UNIT_CNT);
+      printf("%-12s %6u %6u %12u %7.2fx\n", scenes[s].name, tiles[t], units,
+             us, us ? (double)base_us / us : 0.0);
+    }
+  }
+
+  // 自适应刷新：空闲（只有 GIF 帧）与活动（持续视线命令）时的 CPU 占用
+  static const bench_power_t powers[] = {
+      {"idle", false, 0},
+      {"idle", false, BENCH_IDLE_PERIOD_US},
+      {"active", true, 0},
+      {"active", true, BENCH_IDLE_PERIOD_US},
+  };
+  static const bench_scene_t still = {"still", false, true};
+
+  eye_loop_init();
+  eye_frame_sched_init(disps, 2, 0);
+  bench_prepare_eye(&left_eye, &still);
+  bench_prepare_eye(&right_eye, &still);
+  eye_controller_set_render_tiles(0);
+
+  printf("\n%-12s %9s %8s %10s %8s\n", "state", "adaptive", "cpu",
+         "wakeups/s", "fps");
+  for (uint32_t i = 0; i < sizeof(powers) / sizeof(powers[0]); i++) {
+    bench_run_power(eyes, &powers[i]);
+  }
+
+  eye_controller_deinit();
+
+  // 多面板扩展：每种眼睛数重新初始化一次 LVGL
+  bench_run_scaling(assets);
+
+  // SPI 等 deferred I/O 面板只写变化的像素
+  bench_run_deferred_io(assets);
+  return 0;
+}
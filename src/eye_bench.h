@@ -0,0 +1,26 @@
+#ifndef EYE_BENCH_H
+#define EYE_BENCH_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 基准测试所用的眼睛素材 */
+typedef struct {
+  const char *left_eye_path;
+  const char *left_eyelid_path;
+  const char *right_eye_path;
+  const char *right_eyelid_path;
+  uint32_t max_offset_px;
+} eye_bench_assets_t;
+
+/* 在内存显示器上渲染真实眼睛场景，打印不同分块数下的帧耗时与加速比 */
+int eye_bench_run(const eye_bench_assets_t *assets);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EYE_BENCH_H */
@@ -0,0 +1,99 @@
+#include "eye_blink_sched.h"
+
+#include <stddef.h>
+
+#include "eye_rand.h"
+
+static float _uniform(eye_blink_sched_t *sched) {
+  return eye_rand_uniform(&sched->rng);
+}
+
+static uint64_t _interval_us(eye_blink_sched_t *sched) {
+  const eye_blink_config_t *cfg = &sched->cfg;
+  float ms;
+
+  switch (cfg->dist) {
+    case EYE_BLINK_DIST_UNIFORM: {
+      uint32_t span = cfg->interval_ms_max > cfg->interval_ms_min
+                          ? cfg->interval_ms_max - cfg->interval_ms_min
+                          : 0;
+      ms = cfg->interval_ms_min + _uniform(sched) * (float)span;
+      break;
+    }
+    case EYE_BLINK_DIST_EXP: {
+      float extra = cfg->interval_ms_mean > cfg->interval_ms_min
+                        ? (float)(cfg->interval_ms_mean - cfg->interval_ms_min)
+                        : 0.0f;
+      ms = cfg->interval_ms_min + eye_rand_exp(&sched->rng, extra);
+      if (cfg->interval_ms_max && ms > cfg->interval_ms_max) {
+        ms = (float)cfg->interval_ms_max;
+      }
+      break;
+    }
+    default:
+      ms = (float)cfg->interval_ms_mean;
+      break;
+  }
+  if (ms < 1.0f) ms = 1.0f;
+  return (uint64_t)(ms * 1000.0f);
+}
+
+void eye_blink_default_config(eye_blink_config_t *cfg) {
+  cfg->dist = EYE_BLINK_DIST_EXP;
+  cfg->interval_ms_min = EYE_BLINK_INTERVAL_MS_MIN;
+  cfg->interval_ms_mean = EYE_BLINK_INTERVAL_MS_MEAN;
+  cfg->interval_ms_max = EYE_BLINK_INTERVAL_MS_MAX;
+  cfg->double_prob = EYE_BLINK_DOUBLE_PROB;
+  cfg->double_gap_ms = EYE_BLINK_DOUBLE_GAP_MS;
+  cfg->gaze_amp = EYE_BLINK_GAZE_AMP;
+  cfg->gaze_prob = EYE_BLINK_GAZE_PROB;
+  cfg->refractory_ms = EYE_BLINK_REFRACTORY_MS;
+  cfg->seed = 0;
+}
+
+void eye_blink_sched_init(eye_blink_sched_t *sched,
+                          const eye_blink_config_t *cfg, uint64_t now_us) {
+  if (cfg) {
+    sched->cfg = *cfg;
+  } else {
+    eye_blink_default_config(&sched->cfg);
+  }
+
+  eye_rand_seed(&sched->rng, sched->cfg.seed, now_us, 2246822519u);
+
+  sched->last_us = 0;
+  sched->double_pending = false;
+  sched->next_us = now_us + _interval_us(sched);
+}
+
+bool eye_blink_sched_update(eye_blink_sched_t *sched, uint64_t now_us,
+                            bool busy) {
+  if (busy || now_us < sched->next_us) return false;
+
+  sched->last_us = now_us;
+  sched->double_pending = _uniform(sched) < sched->cfg.double_prob;
+  sched->next_us = now_us + _interval_us(sched);
+  return true;
+}
+
+void eye_blink_sched_finished(eye_blink_sched_t *sched, uint64_t now_us) {
+  if (!sched->double_pending) return;
+  sched->double_pending = false;
+  sched->next_us = now_us + sched->cfg.double_gap_ms * 1000ULL;
+}
+
+bool eye_blink_sched_gaze(eye_blink_sched_t *sched, uint64_t now_us, float amp) {
+  const eye_blink_config_t *cfg = &sched->cfg;
+
+  if (cfg->gaze_amp <= 0.0f || amp < cfg->gaze_amp) return false;
+  if (now_us < sched->last_us + cfg->refractory_ms * 1000ULL) return false;
+  if (sched->next_us <= now_us) return false;  // 已经到期
+  if (_uniform(sched) >= cfg->gaze_prob) return false;
+
+  sched->next_us = now_us;
+  return true;
+}
+
+uint64_t eye_blink_sched_next_us(const eye_blink_sched_t *sched) {
+  return sched->next_us;
+}
@@ -0,0 +1,84 @@
+#ifndef EYE_BLINK_SCHED_H
+#define EYE_BLINK_SCHED_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 自然眨眼
+ *
+ * 决定什么时候眨眼：间隔按配置的分布随机取值，眨完有一定概率紧接着再眨一次，
+ * 大幅度的视线跳动也可能触发眨眼（人在扫视时常常顺带眨眼）。
+ * 只负责时刻，眨眼本身由控制器在共用的眼皮时钟上播放。
+ *
+ * 随机数用种子固定的 xorshift，不分配内存。
+ */
+
+#define EYE_BLINK_INTERVAL_MS_MIN 1500   // 两次眨眼的最短间隔
+#define EYE_BLINK_INTERVAL_MS_MEAN 4000  // 平均间隔
+#define EYE_BLINK_INTERVAL_MS_MAX 12000  // 最长间隔
+#define EYE_BLINK_DOUBLE_PROB 0.12f      // 连眨两次的概率
+#define EYE_BLINK_DOUBLE_GAP_MS 80       // 连眨时两次之间的停顿
+#define EYE_BLINK_GAZE_AMP 0.6f          // 触发眨眼的视线跳动幅度（相对 max_offset）
+#define EYE_BLINK_GAZE_PROB 0.4f         // 大幅跳动时眨眼的概率
+#define EYE_BLINK_REFRACTORY_MS 600      // 眨眼开始后这段时间内不再触发
+
+typedef enum {
+  EYE_BLINK_DIST_FIXED,        // 固定为 interval_ms_mean
+  EYE_BLINK_DIST_UNIFORM,      // interval_ms_min ~ interval_ms_max 均匀分布
+  EYE_BLINK_DIST_EXP,          // 最短间隔加指数分布，平均为 interval_ms_mean，截断到最长间隔
+} eye_blink_dist_t;
+
+typedef struct {
+  eye_blink_dist_t dist;
+  uint32_t interval_ms_min;
+  uint32_t interval_ms_mean;
+  uint32_t interval_ms_max;
+  float double_prob;           // 0 关闭连眨
+  uint32_t double_gap_ms;
+  float gaze_amp;              // 0 关闭视线触发
+  float gaze_prob;
+  uint32_t refractory_ms;
+  uint32_t seed;               // 随机数种子，0 表示由当前时刻生成
+} eye_blink_config_t;
+
+typedef struct {
+  eye_blink_config_t cfg;
+  uint32_t rng;
+  uint64_t next_us;            // 下次眨眼时刻
+  uint64_t last_us;            // 上次眨眼开始时刻
+  bool double_pending;         // 这次眨完后再眨一次
+} eye_blink_sched_t;
+
+/* 填入默认参数 */
+void eye_blink_default_config(eye_blink_config_t *cfg);
+
+/* 初始化，cfg 为 NULL 时使用默认参数 */
+void eye_blink_sched_init(eye_blink_sched_t *sched,
+                          const eye_blink_config_t *cfg, uint64_t now_us);
+
+/*
+ * 到了眨眼时刻且 busy 为 false（上一次眨眼已经结束）时返回 true，
+ * 调用者应立即开始眨眼；busy 时保持到期状态，眨完再眨
+ */
+bool eye_blink_sched_update(eye_blink_sched_t *sched, uint64_t now_us,
+                            bool busy);
+
+/* 一次眨眼播放结束 */
+void eye_blink_sched_finished(eye_blink_sched_t *sched, uint64_t now_us);
+
+/* 视线目标跳动了 amp（相对 max_offset），可能触发眨眼；返回 true 表示需要立即检查 */
+bool eye_blink_sched_gaze(eye_blink_sched_t *sched, uint64_t now_us, float amp);
+
+/* 下次眨眼时刻 */
+uint64_t eye_blink_sched_next_us(const eye_blink_sched_t *sched);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EYE_BLINK_SCHED_H */
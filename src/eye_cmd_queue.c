@@ -0,0 +1,151 @@
+#include "eye_cmd_queue.h"
+
+#include <string.h>
+
+#define QUEUE_MASK (EYE_CMD_QUEUE_LEN - 1)
+
+/* seq 记录槽位状态：等于写入位置时可写，等于写入位置 + 1 时可读 */
+typedef struct {
+  uint32_t seq;
+  eye_cmd_t cmd;
+} cmd_slot_t;
+
+/* 视线信箱：目标打包成 64 位（x/y 或注视点的 x/y/z），pending 表示有未处理的目标 */
+typedef struct {
+  uint64_t target;
+  uint32_t pending;
+} gaze_slot_t;
+
+static cmd_slot_t g_slots[EYE_CMD_QUEUE_LEN];
+static uint32_t g_head;  // 下一个写入位置（生产者竞争）
+static uint32_t g_tail;  // 下一个读取位置（只有渲染线程访问）
+static gaze_slot_t g_gaze[EYE_CMD_GAZE_SLOTS];
+static gaze_slot_t g_point;
+static eye_cmd_stats_t g_stats;
+
+static void _count(uint32_t *cnt) {
+  __atomic_fetch_add(cnt, 1, __ATOMIC_RELAXED);
+}
+
+void eye_cmd_queue_reset(void) {
+  for (uint32_t i = 0; i < EYE_CMD_QUEUE_LEN; i++) g_slots[i].seq = i;
+  g_head = g_tail = 0;
+  memset(g_gaze, 0, sizeof(g_gaze));
+  memset(&g_point, 0, sizeof(g_point));
+  memset(&g_stats, 0, sizeof(g_stats));
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+bool eye_cmd_queue_push(const eye_cmd_t *cmd) {
+  uint32_t pos = __atomic_load_n(&g_head, __ATOMIC_RELAXED);
+  cmd_slot_t *slot;
+
+  // 抢占一个可写的槽位；槽位还没被读走说明队列已满
+  for (;;) {
+    slot = &g_slots[pos & QUEUE_MASK];
+    int32_t diff =
+        (int32_t)(__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) - pos);
+    if (diff == 0) {
+      if (__atomic_compare_exchange_n(&g_head, &pos, pos + 1, true,
+                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        break;
+      }
+    } else if (diff < 0) {
+      _count(&g_stats.drop_cnt);
+      return false;
+    } else {
+      pos = __atomic_load_n(&g_head, __ATOMIC_RELAXED);
+    }
+  }
+
+  slot->cmd = *cmd;
+  __atomic_store_n(&slot->seq, pos + 1, __ATOMIC_RELEASE);
+  _count(&g_stats.push_cnt);
+  return true;
+}
+
+/* 写入信箱，返回 true 表示信箱原来是空的 */
+static bool _post_slot(gaze_slot_t *slot, uint64_t target) {
+  // 先写目标再置位，取目标的一方看到 pending 时目标一定已经写好
+  __atomic_store_n(&slot->target, target, __ATOMIC_RELAXED);
+  _count(&g_stats.gaze_cnt);
+  if (__atomic_exchange_n(&slot->pending, 1, __ATOMIC_ACQ_REL)) {
+    _count(&g_stats.coalesced_cnt);
+    return false;
+  }
+  return true;
+}
+
+/* 取出信箱中的目标，没有新目标返回 false */
+static bool _take_slot(gaze_slot_t *slot, uint64_t *target) {
+  if (!__atomic_exchange_n(&slot->pending, 0, __ATOMIC_ACQ_REL)) return false;
+  *target = __atomic_load_n(&slot->target, __ATOMIC_RELAXED);
+  return true;
+}
+
+bool eye_cmd_queue_post_gaze(uint32_t eye_idx, int32_t x, int32_t y) {
+  if (eye_idx >= EYE_CMD_GAZE_SLOTS) return false;
+  return _post_slot(&g_gaze[eye_idx], (uint64_t)(uint32_t)x << 32 | (uint32_t)y);
+}
+
+bool eye_cmd_queue_post_point(int16_t x, int16_t y, int16_t z) {
+  return _post_slot(&g_point, (uint64_t)(uint16_t)x << 32 |
+                                  (uint64_t)(uint16_t)y << 16 | (uint16_t)z);
+}
+
+uint32_t eye_cmd_queue_drain(eye_cmd_handler_t handler, void *user_data) {
+  uint32_t cnt = 0;
+
+  // 最多处理一圈，处理函数再投递的命令留到下一帧
+  for (uint32_t n = 0; n < EYE_CMD_QUEUE_LEN; n++) {
+    cmd_slot_t *slot = &g_slots[g_tail & QUEUE_MASK];
+    if (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != g_tail + 1) break;
+
+    handler(&slot->cmd, user_data);
+    __atomic_store_n(&slot->seq, g_tail + EYE_CMD_QUEUE_LEN, __ATOMIC_RELEASE);
+    g_tail++;
+    cnt++;
+  }
+
+  uint64_t target;
+  if (_take_slot(&g_point, &target)) {
+    eye_cmd_t cmd = {.type = EYE_CMD_LOOK_AT_POINT};
+    cmd.point.x = (int16_t)(uint16_t)(target >> 32);
+    cmd.point.y = (int16_t)(uint16_t)(target >> 16);
+    cmd.point.z = (int16_t)(uint16_t)target;
+    handler(&cmd, user_data);
+    cnt++;
+  }
+
+  // 单眼目标在注视点之后处理，同一帧里以单眼目标为准
+  for (uint32_t i = 0; i < EYE_CMD_GAZE_SLOTS; i++) {
+    if (!_take_slot(&g_gaze[i], &target)) continue;
+
+    eye_cmd_t cmd = {.type = EYE_CMD_GAZE};
+    cmd.gaze.eye_idx = i;
+    cmd.gaze.x = (int32_t)(uint32_t)(target >> 32);
+    cmd.gaze.y = (int32_t)(uint32_t)target;
+    handler(&cmd, user_data);
+    cnt++;
+  }
+
+  __atomic_fetch_add(&g_stats.drain_cnt, cnt, __ATOMIC_RELAXED);
+  return cnt;
+}
+
+void eye_cmd_queue_get_stats(eye_cmd_stats_t *stats, bool reset) {
+  stats->push_cnt = __atomic_load_n(&g_stats.push_cnt, __ATOMIC_RELAXED);
+  stats->drop_cnt = __atomic_load_n(&g_stats.drop_cnt, __ATOMIC_RELAXED);
+  stats->gaze_cnt = __atomic_load_n(&g_stats.gaze_cnt, __ATOMIC_RELAXED);
+  stats->coalesced_cnt =
+      __atomic_load_n(&g_stats.coalesced_cnt, __ATOMIC_RELAXED);
+  stats->drain_cnt = __atomic_load_n(&g_stats.drain_cnt, __ATOMIC_RELAXED);
+  if (reset) {
+    __atomic_fetch_sub(&g_stats.push_cnt, stats->push_cnt, __ATOMIC_RELAXED);
+    __atomic_fetch_sub(&g_stats.drop_cnt, stats->drop_cnt, __ATOMIC_RELAXED);
+    __atomic_fetch_sub(&g_stats.gaze_cnt, stats->gaze_cnt, __ATOMIC_RELAXED);
+    __atomic_fetch_sub(&g_stats.coalesced_cnt, stats->coalesced_cnt,
+                       __ATOMIC_RELAXED);
+    __atomic_fetch_sub(&g_stats.drain_cnt, stats->drain_cnt, __ATOMIC_RELAXED);
+  }
+}
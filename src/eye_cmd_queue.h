@@ -0,0 +1,112 @@
+#ifndef EYE_CMD_QUEUE_H
+#define EYE_CMD_QUEUE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "eye_blink_sched.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 命令队列
+ *
+ * 任意线程投递，渲染线程每帧取出一次；投递路径不分配内存、不加锁：
+ *  - 普通命令进入固定容量的多生产者单消费者环形队列，队满时丢弃并计数
+ *  - 视线命令每只眼只有一个信箱，后写覆盖先写，不占队列位置；
+ *    渲染线程来不及处理的旧目标直接被新目标替换，不会堆积
+ *  - 双眼注视点（三维坐标）同样只有一个信箱，两只眼在同一帧生效
+ */
+
+#define EYE_CMD_QUEUE_LEN 16   // 环形队列容量，必须是 2 的幂
+#define EYE_CMD_GAZE_SLOTS 4   // 视线信箱个数，与 EYE_MAX_CNT 一致
+#define EYE_CMD_PATH_MAX 128   // 命令中素材路径的最大长度（含结尾 0）
+
+struct eye_t;
+
+typedef enum {
+  EYE_CMD_GAZE,             // 视线目标（只由信箱产生，不能入队）
+  EYE_CMD_BLINK,            // 设置定时眨眼
+  EYE_CMD_BLINK_NATURAL,    // 设置自然眨眼
+  EYE_CMD_SWITCH_MATERIAL,  // 切换左右眼素材
+  EYE_CMD_LOOK_AT_POINT,    // 双眼注视点（只由信箱产生，不能入队）
+  EYE_CMD_EYELID_OPENNESS,  // 眼皮开度
+  EYE_CMD_EYELID_COUPLING,  // 眼皮跟随视线的系数
+} eye_cmd_type_t;
+
+typedef struct {
+  eye_cmd_type_t type;
+  union {
+    struct {
+      uint32_t eye_idx;
+      int32_t x;
+      int32_t y;
+    } gaze;
+    struct {
+      int32_t x, y, z;        // mm
+    } point;
+    struct {
+      uint32_t interval_ms;
+      int32_t count;
+    } blink;
+    struct {
+      struct eye_t *eye;      // NULL 表示所有眼睛
+      uint32_t pct;
+      uint32_t duration_ms;
+    } openness;
+    struct {
+      struct eye_t *eye;      // NULL 表示所有眼睛
+      float k;
+    } coupling;
+    struct {
+      bool use_default;
+      eye_blink_config_t cfg;
+    } blink_natural;
+    struct {
+      struct eye_t *eyes[2];  // 左、右眼
+      char eye_path[2][EYE_CMD_PATH_MAX];
+      char eyelid_path[2][EYE_CMD_PATH_MAX];
+      int32_t max_offset_px[2];
+    } material;
+  };
+} eye_cmd_t;
+
+typedef struct {
+  uint32_t push_cnt;       // 入队的普通命令
+  uint32_t drop_cnt;       // 队满丢弃的普通命令
+  uint32_t gaze_cnt;       // 投递的视线命令
+  uint32_t coalesced_cnt;  // 处理前被新目标覆盖的视线命令
+  uint32_t drain_cnt;      // 渲染线程处理的命令（含视线）
+} eye_cmd_stats_t;
+
+typedef void (*eye_cmd_handler_t)(const eye_cmd_t *cmd, void *user_data);
+
+/* 清空队列和信箱（没有生产者时调用） */
+void eye_cmd_queue_reset(void);
+
+/* 投递一条普通命令（线程安全）；队满返回 false */
+bool eye_cmd_queue_push(const eye_cmd_t *cmd);
+
+/*
+ * 投递第 eye_idx 只眼的视线目标（线程安全）
+ * 返回 true 表示信箱原来是空的，调用者需要唤醒渲染线程；
+ * false 表示覆盖了一个尚未处理的目标，唤醒已经在路上
+ */
+bool eye_cmd_queue_post_gaze(uint32_t eye_idx, int32_t x, int32_t y);
+
+/* 投递双眼注视点（线程安全，坐标为 mm，范围为 int16），返回值同上 */
+bool eye_cmd_queue_post_point(int16_t x, int16_t y, int16_t z);
+
+/* 渲染线程调用：先按顺序处理队列中的命令，再处理最新的注视点和各眼视线目标 */
+uint32_t eye_cmd_queue_drain(eye_cmd_handler_t handler, void *user_data);
+
+/* 读取统计信息 */
+void eye_cmd_queue_get_stats(eye_cmd_stats_t *stats, bool reset);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EYE_CMD_QUEUE_H */
@@ -23,119 +23,261 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <linux/fb.h>
-#include <pthread.h>
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/epoll.h>
 #include <sys/ioctl.h>
 #include <sys/mman.h>
-#include <sys/time.h>
 #include <time.h>
 #include <unistd.h>
 
+#include "eye_cmd_queue.h"
+#include "eye_frame_sched.h"
+#include "eye_gaze_shm.h"
+#include "eye_gif_player.h"
+#include "eye_loop.h"
+#include "eye_present.h"
+#include "eye_tick.h"
+#include "lib/drm_display.h"
+#include "lib/fbdev_display.h"
 #include "lvgl.h"
 
 #define SCREEN_DIAMETER 240  // px
-#define RANDOM_LOOK 0        // 随机移动视线测试
-
-__attribute__((section(".fast_ram")))
-lv_color_t buf00[SCREEN_DIAMETER * SCREEN_DIAMETER];
+#define IDLE_GAZE 1          // 没有外部视线命令时自动扫视、微扫视
+#define RENDER_TILE_CNT 0    // 每屏并行渲染分块数，0 表示按在线 CPU 数自动选择
+#define LAYER_CACHE 1        // 眼皮静止时使用预合成的静态图层
+#define FBDEV_ZERO_COPY 1    // 直接渲染到 mmap 的 framebuffer（条件不满足时回退为拷贝）
+#define FBDEV_PAGE_FLIP 1    // 双页 + FBIOPAN_DISPLAY 翻页，避免撕裂
+#define FBDEV_ASYNC_FLUSH 1  // 拷贝模式下由工作线程写 framebuffer，渲染不等待拷贝
+#define FRAME_PERIOD_US 0    // 帧周期，0 表示使用面板刷新周期
+#define FRAME_IDLE_PERIOD_US 50000  // 无动画时的帧周期，0 表示始终全速
+#define STATS_PERIOD_MS 2000 // 统计输出周期，0 表示不输出
+#define GIF_CATCHUP EYE_GIF_CATCHUP_SKIP  // GIF 落后时跳帧，保持实际播放速度
+#define SCLERA_COLOR lv_color_make(214, 214, 206)  // 眼底色
+
+#define FAST_BUF_CNT 2       // 放在 .fast_ram 中的渲染缓冲区个数，其余面板动态分配
+
+// 拷贝模式下的渲染缓冲区（零拷贝时直接渲染到 framebuffer，不使用）
 __attribute__((section(".fast_ram")))
-lv_color_t buf01[SCREEN_DIAMETER * SCREEN_DIAMETER];
+lv_color_t g_fast_bufs[FAST_BUF_CNT][SCREEN_DIAMETER * SCREEN_DIAMETER];
+static uint32_t g_fast_buf_used;
+
+static const char *const g_eye_names[EYE_MAX_CNT] = {"eye0", "eye1", "eye2",
+                                                     "eye3"};
 
 // 全局眼皮控制器实例
 static eyelid_controller_t g_eyelid_controller = {0};
 
-static void _gif_reset_and_play(lv_obj_t *gif, int32_t loop_count,
-                                bool resume) {
-  if (!gif) return;
-  lv_gif_restart(gif);
-  lv_gif_pause(gif);
-  lv_gif_set_loop_count(gif, loop_count);  // n 或 -1（无限）
-  if (resume) {
-    lv_gif_resume(gif);
+// 共享内存视线输入，未开启时为 NULL
+static eye_gaze_shm_t *g_gaze_shm;
+
+/* 眼皮即将播放：静态图层缓存失效 */
+static void _eyelid_cache_invalidate(struct eye_t *eye) {
+  if (eye && eye->eyelid_gif) eye_layer_cache_invalidate(&eye->layer_cache);
+}
+
+/* 所有眼皮挂到共用时钟上，从第一帧同时开始播放 */
+static void _eyelid_sync_play(eyelid_controller_t *controller,
+                              int32_t loop_count) {
+  for (uint32_t i = 0; i < controller->eye_cnt; i++) {
+    struct eye_t *eye = controller->eyes[i];
+    if (!eye->eyelid_gif) continue;
+    _eyelid_cache_invalidate(eye);
+    eye_gif_player_attach(eye->eyelid_gif, &controller->eyelid_clock);
+    // n 或 -1（无限）；左右眼皮帧数不同时，无限循环每轮会错开一帧
+    eye_gif_player_set_loop_count(eye->eyelid_gif, loop_count);
   }
+  eye_anim_clock_restart(&controller->eyelid_clock);
 }
 
-/* ==================== 执行单次眨眼（眼皮） ==================== */
-static void perform_single_eyelid_blink(struct eye_t *eye) {
-  if (!eye || !eye->eyelid_gif) return;
-  _gif_reset_and_play(eye->eyelid_gif, 1, true);
+/* 停下所有眼皮动画（共用时钟和各眼自己的时钟） */
+static void _eyelid_pause_all(eyelid_controller_t *controller) {
+  eye_anim_clock_pause(&controller->eyelid_clock);
+  for (uint32_t i = 0; i < controller->eye_cnt; i++) {
+    eye_anim_clock_pause(&controller->eyes[i]->lid_clock);
+  }
 }
 
-/* ==================== 统一的眼皮眨眼定时器回调 ==================== */
-static void unified_eyelid_blink_timer_cb(lv_timer_t *timer) {
-  eyelid_controller_t *controller = lv_timer_get_user_data(timer);
-  if (!controller) return;
+/* ==================== 眼皮开度：按帧表直接显示某一帧 ==================== */
+#define LID_ANIM_RES 1024  // 开度过渡动画的数值范围
 
-  // 如果上一次眨眼还没同步完成，直接返回，不启动新的
-  if (controller->waiting_for_sync) {
-    return;
-  }
+/* 眨眼播放期间由时钟决定显示哪一帧，开度只记下来，眨完再显示 */
+static bool _lid_playing(struct eye_t *eye) {
+  return !g_eyelid_controller.eyelid_clock.paused || !eye->lid_clock.paused;
+}
 
-  // 如果是有限次数且已用完，也不再触发
-  if (controller->blink_remaining > 0 && controller->blink_remaining <= 0) {
-    lv_timer_pause(timer);
-    return;
+/* 实际显示的开度：设定值加上视线带动的部分（眼球的当前位置，不是目标） */
+static float _lid_effective(const struct eye_t *eye) {
+  float open = eye->lid_open;
+  if (eye->lid_gaze_coupling != 0.0f && eye->max_offset > 0) {
+    open -= eye->lid_gaze_coupling * eye->gaze.y / (float)eye->max_offset;
   }
+  return open < 0.0f ? 0.0f : (open > 1.0f ? 1.0f : open);
+}
 
-  // 开始一次新的眨眼会话
-  controller->waiting_for_sync = true;
-  controller->left_finished = false;
-  controller->right_finished = false;
+/* 显示当前开度对应的帧：第一帧为睁开，帧表的最后一帧闭得最紧；完全睁开时不建表 */
+static void _lid_show(struct eye_t *eye) {
+  eye_gif_frames_t *frames = &eye->lid_frames;
 
-  // 两只眼皮都设置为单次播放并启动
-  if (controller->left_eye && controller->left_eye->eyelid_gif) {
-    lv_gif_restart(controller->left_eye->eyelid_gif);
-    lv_gif_set_loop_count(controller->left_eye->eyelid_gif, 1);
-    lv_gif_resume(controller->left_eye->eyelid_gif);
+  if (!eye->eyelid_gif || _lid_playing(eye)) return;
+  float open = _lid_effective(eye);
+  if (frames->frame_cnt == 0) {
+    if (open >= 1.0f) return;
+    if (eye_gif_frames_build(frames, eye->eyelid_gif) < 0) return;
   }
-  if (controller->right_eye && controller->right_eye->eyelid_gif) {
-    lv_gif_restart(controller->right_eye->eyelid_gif);
-    lv_gif_set_loop_count(controller->right_eye->eyelid_gif, 1);
-    lv_gif_resume(controller->right_eye->eyelid_gif);
+
+  uint32_t last = frames->frame_cnt - 1;
+  uint32_t idx = (uint32_t)lroundf((1.0f - open) * (float)last);
+  if (idx == frames->shown) return;
+  eye_layer_cache_invalidate(&eye->layer_cache);
+  eye_gif_frames_show(frames, eye->eyelid_gif, idx);
+}
+
+/* 视线带动眼皮时提前建表，往下看时不在视线动画的回调里解码整个 GIF */
+static void _lid_prepare(struct eye_t *eye) {
+  if (!eye->eyelid_gif || eye->lid_gaze_coupling == 0.0f) return;
+  if (eye->lid_frames.frame_cnt || _lid_playing(eye)) return;
+  eye_gif_frames_build(&eye->lid_frames, eye->eyelid_gif);
+}
+
+static void _lid_anim_cb(lv_anim_t *a, int32_t v) {
+  struct eye_t *eye = lv_anim_get_user_data(a);
+  eye->lid_open =
+      eye->lid_from + (eye->lid_to - eye->lid_from) * v / (float)LID_ANIM_RES;
+  _lid_show(eye);
+}
+
+/* 眼皮不再变化时重建静态图层缓存 */
+static void _lid_settle(struct eye_t *eye) {
+  if (eye->layer_cache.valid || _lid_playing(eye)) return;
+  if (lv_anim_get(&eye->lid_frames, NULL)) return;  // 开度还在过渡
+  if (eye->lid_gaze_coupling != 0.0f && eye->gaze_moving) return;
+  eye_layer_cache_build(&eye->layer_cache);
+}
+
+static void _lid_anim_completed_cb(lv_anim_t *a) {
+  _lid_settle(lv_anim_get_user_data(a));
+}
+
+/* 停止开度过渡，直接停在目标开度 */
+static void _lid_anim_stop(struct eye_t *eye) {
+  if (lv_anim_delete(&eye->lid_frames, NULL)) eye->lid_open = eye->lid_to;
+}
+
+static void _lid_set_openness_impl(struct eye_t *eye, uint32_t pct,
+                                   uint32_t duration_ms) {
+  if (!eye || !eye->eyelid_gif) return;
+
+  float to = (pct > 100 ? 100 : pct) / 100.0f;
+  lv_anim_delete(&eye->lid_frames, NULL);
+  eye->lid_from = eye->lid_open;
+  eye->lid_to = to;
+
+  if (duration_ms == 0 || to == eye->lid_open || _lid_playing(eye)) {
+    eye->lid_open = to;
+    _lid_show(eye);
+    _lid_settle(eye);
+    return;
   }
+
+  // 动画的变量是帧表而不是眼睛，删除视线动画时不会带走它
+  lv_anim_t a;
+  lv_anim_init(&a);
+  lv_anim_set_var(&a, &eye->lid_frames);
+  lv_anim_set_user_data(&a, eye);
+  lv_anim_set_values(&a, 0, LID_ANIM_RES);
+  lv_anim_set_duration(&a, duration_ms);
+  lv_anim_set_path_cb(&a, lv_anim_path_ease_in_out);
+  lv_anim_set_custom_exec_cb(&a, _lid_anim_cb);
+  lv_anim_set_completed_cb(&a, _lid_anim_completed_cb);
+  lv_anim_start(&a);
 }
 
-/* 事件回调：只要任意一只眼球 GIF 播放完一圈，就强制另一只同步 */
-static void eye_gif_sync_event_cb(lv_event_t *e) {
-  lv_obj_t *triggered_gif = lv_event_get_target(e);
+/* 眼皮静止：回到设定的开度，重建所有眼睛的静态图层缓存 */
+static void _eyelid_cache_build_all(eyelid_controller_t *controller) {
+  for (uint32_t i = 0; i < controller->eye_cnt; i++) {
+    struct eye_t *eye = controller->eyes[i];
+    eye->lid_frames.shown = UINT32_MAX;  // 画面停在眨眼播放到的帧
+    _lid_prepare(eye);
+    _lid_show(eye);
+    eye_layer_cache_build(&eye->layer_cache);
+  }
+}
 
-  lv_obj_t *other_gif = (triggered_gif == g_eyelid_controller.left_eye->eye_gif)
-                            ? g_eyelid_controller.right_eye->eye_gif
-                            : g_eyelid_controller.left_eye->eye_gif;
+#define BLINK_BUSY_POLL_MS 100  // 到期时上一次眨眼还没结束，隔一段时间再看
 
-  if (!other_gif) return;
-  lv_gif_restart(other_gif);
+/* 自然眨眼：定时器睡到下次眨眼时刻 */
+static void _blink_timer_rearm(eyelid_controller_t *controller,
+                               uint64_t now) {
+  uint64_t next = eye_blink_sched_next_us(&controller->blink_sched);
+  uint64_t wait_ms = next > now ? (next - now + 999) / 1000 : BLINK_BUSY_POLL_MS;
+  lv_timer_set_period(controller->blink_timer, (uint32_t)wait_ms);
 }
 
-/* 事件回调：当任意一只眼皮 GIF 播放完一圈（单次）时触发 */
-static void eyelid_gif_finished_cb(lv_event_t *e) {
-  lv_obj_t *gif = lv_event_get_target(e);
-  eyelid_controller_t *controller = &g_eyelid_controller;
+/* 所有眼皮都播放结束：最后一帧已渲染，直接重建静态图层缓存 */
+static void _eyelid_sync_finished_cb(eye_anim_clock_t *clock, void *user_data) {
+  eyelid_controller_t *controller = user_data;
 
-  bool is_left = (gif == controller->left_eye->eyelid_gif);
+  _eyelid_cache_build_all(controller);
 
-  if (is_left) {
-    controller->left_finished = true;
-  } else {
-    controller->right_finished = true;
+  if (controller->blink_natural) {
+    uint64_t now = eye_tick_us();
+    eye_blink_sched_finished(&controller->blink_sched, now);
+    _blink_timer_rearm(controller, now);
+    return;
+  }
+
+  // 如果是有限次数，减少计数
+  if (controller->blink_remaining > 0) {
+    controller->blink_remaining--;
+    if (controller->blink_remaining == 0) {
+      lv_timer_pause(controller->blink_timer);
+    }
   }
+}
 
-  // 如果两只眼都完成了，解除等待状态
-  if (controller->left_finished && controller->right_finished) {
-    controller->waiting_for_sync = false;
-    controller->left_finished = false;
-    controller->right_finished = false;
+/* 单只眼皮播放结束 */
+static void _eyelid_single_finished_cb(eye_anim_clock_t *clock,
+                                       void *user_data) {
+  struct eye_t *eye = user_data;
+  eye->lid_frames.shown = UINT32_MAX;
+  _lid_prepare(eye);
+  _lid_show(eye);
+  eye_layer_cache_build(&eye->layer_cache);
+}
 
-    // 如果是有限次数，减少计数
-    if (controller->blink_remaining > 0) {
-      controller->blink_remaining--;
-      if (controller->blink_remaining == 0) {
-        lv_timer_pause(controller->blink_timer);
-      }
+/* ==================== 执行单次眨眼（眼皮） ==================== */
+static void perform_single_eyelid_blink(struct eye_t *eye) {
+  if (!eye || !eye->eyelid_gif) return;
+  _eyelid_cache_invalidate(eye);
+  eye_gif_player_attach(eye->eyelid_gif, &eye->lid_clock);
+  eye_gif_player_set_loop_count(eye->eyelid_gif, 1);
+  eye_anim_clock_restart(&eye->lid_clock);
+}
+
+/* ==================== 统一的眼皮眨眼定时器回调 ==================== */
+static void unified_eyelid_blink_timer_cb(lv_timer_t *timer) {
+  eyelid_controller_t *controller = lv_timer_get_user_data(timer);
+  if (!controller) return;
+
+  // 共用时钟还在走说明上一次眨眼没有结束（时钟没有图层时也会停下，不会卡住）
+  bool busy = !controller->eyelid_clock.paused;
+
+  if (controller->blink_natural) {
+    uint64_t now = eye_tick_us();
+    if (eye_blink_sched_update(&controller->blink_sched, now, busy)) {
+      _eyelid_sync_play(controller, 1);
     }
+    _blink_timer_rearm(controller, now);
+    return;
   }
+
+  if (busy) return;
+
+  // 开始一次新的眨眼会话：所有眼皮单次播放，共用一个时钟
+  _eyelid_sync_play(controller, 1);
 }
 
 /* ==================== 创建眼睛（移除独立的眨眼定时器） ==================== */
@@ -146,47 +288,59 @@ static void eye_create(lv_disp_t *disp, struct eye_t *eye,
 
   eye->disp = disp;
   eye->max_offset = max_offset;
+  eye_gaze_init(&eye->gaze, 0.0f, (float)max_offset);
+  eye->gaze_anim = false;
+  eye->gaze_moving = false;
+  memset(&eye->lid_frames, 0, sizeof(eye->lid_frames));
+  eye->lid_open = eye->lid_from = eye->lid_to = 1.0f;
+  eye->lid_gaze_coupling = 0.0f;
 
   lv_obj_t *bg = lv_obj_create(scr);
   lv_obj_set_size(bg, LV_PCT(240), LV_PCT(240));
-  lv_obj_set_style_bg_color(bg, lv_color_make(214, 214, 206), 0);  // 眼底色
+  lv_obj_set_style_bg_color(bg, SCLERA_COLOR, 0);  // 眼底色
   lv_obj_set_style_bg_opa(bg, LV_OPA_COVER, 0);
   lv_obj_move_background(bg);  // 确保在最底层
+  eye->bg = bg;
 
   eye->eye_gif = lv_gif_create(scr);
   lv_gif_set_src(eye->eye_gif, eye_gif_path);
   lv_obj_center(eye->eye_gif);
-  lv_obj_add_event_cb(eye->eye_gif, eye_gif_sync_event_cb, LV_EVENT_READY,
-                      NULL);
+  eye_gif_player_attach(eye->eye_gif, &g_eyelid_controller.eye_clock);
 
   eye->eyelid_gif = lv_gif_create(scr);
   lv_gif_set_src(eye->eyelid_gif, eyelid_gif_path);
   lv_obj_center(eye->eyelid_gif);
-  lv_gif_pause(eye->eyelid_gif);
 
-  // 新增：监听眼皮 GIF 单次播放完成事件
-  lv_obj_add_event_cb(eye->eyelid_gif, eyelid_gif_finished_cb, LV_EVENT_READY,
-                      NULL);
+  // 眼皮先挂在本眼的时钟上（暂停，停在第一帧）
+  eye_anim_clock_init(&eye->lid_clock, GIF_CATCHUP);
+  eye_anim_clock_set_finished_cb(&eye->lid_clock, _eyelid_single_finished_cb,
+                                 eye);
+  eye_gif_player_attach(eye->eyelid_gif, &eye->lid_clock);
+
+  // 眼皮初始为暂停状态，直接使用预合成图层
+  eye_layer_cache_init(&eye->layer_cache, scr, eye->eyelid_gif);
+  eye_layer_cache_set_enabled(&eye->layer_cache, LAYER_CACHE);
+  eye_layer_cache_build(&eye->layer_cache);
 }
 
 /* ==================== 统一的眼皮眨眼控制函数 ==================== */
 static void _eyelid_blink_impl(uint32_t interval_ms, int32_t count) {
   eyelid_controller_t *controller = &g_eyelid_controller;
-  if (!controller->left_eye && !controller->right_eye) return;
+  if (controller->eye_cnt == 0) return;
 
   // 先停止当前行为
   if (controller->blink_timer) {
     lv_timer_pause(controller->blink_timer);
   }
-  controller->waiting_for_sync = false;  // 重置同步状态
-  controller->left_finished = false;
-  controller->right_finished = false;
+  controller->blink_natural = false;
 
   // 暂停当前动画（防止残留）
-  if (controller->left_eye) lv_gif_pause(controller->left_eye->eyelid_gif);
-  if (controller->right_eye) lv_gif_pause(controller->right_eye->eyelid_gif);
+  _eyelid_pause_all(controller);
 
-  if (count == 0) return;  // 不眨眼
+  if (count == 0) {  // 不眨眼，眼皮保持静止
+    _eyelid_cache_build_all(controller);
+    return;
+  }
 
   controller->blink_interval = interval_ms;
   controller->blink_remaining = count;
@@ -208,243 +362,456 @@ static void _eyelid_blink_impl(uint32_t interval_ms, int32_t count) {
   // 如果是连续无限眨眼（interval_ms == 0 && count == -1）
   if (interval_ms == 0 && count == -1) {
     // 直接让 GIF 无限循环播放（常用于“闭眼”状态）
-    if (controller->left_eye) {
-      lv_gif_restart(controller->left_eye->eyelid_gif);
-      lv_gif_set_loop_count(controller->left_eye->eyelid_gif, -1);
-      lv_gif_resume(controller->left_eye->eyelid_gif);
-    }
-    if (controller->right_eye) {
-      lv_gif_restart(controller->right_eye->eyelid_gif);
-      lv_gif_set_loop_count(controller->right_eye->eyelid_gif, -1);
-      lv_gif_resume(controller->right_eye->eyelid_gif);
-    }
+    _eyelid_sync_play(controller, -1);
     lv_timer_pause(controller->blink_timer);  // 不需要定时器
   } else {
     lv_timer_resume(controller->blink_timer);
   }
 }
 
-typedef struct {
-  uint32_t interval_ms;
-  int32_t count;
-} blink_data_t;
+static void _eyelid_blink_natural_impl(const eye_blink_config_t *cfg) {
+  eyelid_controller_t *controller = &g_eyelid_controller;
+  if (controller->eye_cnt == 0) return;
+
+  // 停下定时眨眼（可能正在无限循环）
+  _eyelid_pause_all(controller);
+  _eyelid_cache_build_all(controller);
 
-static void _eyelid_blink_async_cb(void *user_data) {
-  blink_data_t *data = (blink_data_t *)user_data;
-  if (data) {
-    _eyelid_blink_impl(data->interval_ms, data->count);
-    free(data);
+  uint64_t now = eye_tick_us();
+  controller->blink_natural = true;
+  eye_blink_sched_init(&controller->blink_sched, cfg, now);
+  if (!controller->blink_timer) {
+    controller->blink_timer =
+        lv_timer_create(unified_eyelid_blink_timer_cb, 1, controller);
   }
+  _blink_timer_rearm(controller, now);
+  lv_timer_resume(controller->blink_timer);
 }
 
-void eyelid_blink(uint32_t interval_ms, int32_t count) {
-  blink_data_t *data = (blink_data_t *)malloc(sizeof(blink_data_t));
-  if (data) {
-    data->interval_ms = interval_ms;
-    data->count = count;
-    if (lv_async_call(_eyelid_blink_async_cb, data) != LV_RES_OK) {
-      free(data);
-    }
+/* 视线大幅跳动时可能顺带眨眼，只看第一只眼，双眼同向时不会算两次 */
+static void _blink_gaze_trigger(struct eye_t *eye, int32_t tx, int32_t ty) {
+  eyelid_controller_t *controller = &g_eyelid_controller;
+  if (!controller->blink_natural || eye->idx != 0 || eye->max_offset <= 0) {
+    return;
+  }
+
+  float dx = tx - eye->gaze.tx;
+  float dy = ty - eye->gaze.ty;
+  float amp = sqrtf(dx * dx + dy * dy) / eye->max_offset;
+  if (eye_blink_sched_gaze(&controller->blink_sched, eye_tick_us(), amp)) {
+    lv_timer_ready(controller->blink_timer);
   }
 }
 
+/* 有新命令：恢复全速并立即唤醒主循环 */
+static void _wake_render(void) {
+  eye_frame_sched_kick();
+  eye_loop_wake();
+}
+
+/* 从任意线程投递命令到渲染线程，不分配内存 */
+/* 队满时丢弃；不逐条打印，过载时不再往 stdout 刷屏，丢弃次数由统计定时器报告 */
+static void _post_cmd(const eye_cmd_t *cmd) {
+  if (eye_cmd_queue_push(cmd)) _wake_render();
+}
+
+void eyelid_blink(uint32_t interval_ms, int32_t count) {
+  eye_cmd_t cmd = {.type = EYE_CMD_BLINK};
+  cmd.blink.interval_ms = interval_ms;
+  cmd.blink.count = count;
+  _post_cmd(&cmd);
+}
+
+void eyelid_blink_natural(const eye_blink_config_t *cfg) {
+  eye_cmd_t cmd = {.type = EYE_CMD_BLINK_NATURAL};
+  cmd.blink_natural.use_default = cfg == NULL;
+  if (cfg) cmd.blink_natural.cfg = *cfg;
+  _post_cmd(&cmd);
+}
+
+/* ==================== 眼皮开度与视线联动（经命令队列） ==================== */
+void eyelid_set_openness(struct eye_t *eye, uint32_t pct, uint32_t duration_ms) {
+  eye_cmd_t cmd = {.type = EYE_CMD_EYELID_OPENNESS};
+  cmd.openness.eye = eye;
+  cmd.openness.pct = pct;
+  cmd.openness.duration_ms = duration_ms;
+  _post_cmd(&cmd);
+}
+
+void eyelid_set_gaze_coupling(struct eye_t *eye, float k) {
+  eye_cmd_t cmd = {.type = EYE_CMD_EYELID_COUPLING};
+  cmd.coupling.eye = eye;
+  cmd.coupling.k = k;
+  _post_cmd(&cmd);
+}
+
 /* ==================== 立即眼皮眨眼一次 ==================== */
 void eyelid_blink_once(void) {
   eyelid_controller_t *controller = &g_eyelid_controller;
 
-  // 左眼皮准备
-  if (controller->left_eye && controller->left_eye->eyelid_gif) {
-    _gif_reset_and_play(controller->left_eye->eyelid_gif, 1, false);
-  }
+  // 所有眼皮挂在同一个时钟上，帧级同步
+  _eyelid_sync_play(controller, 1);
+}
 
-  // 右眼皮准备
-  if (controller->right_eye && controller->right_eye->eyelid_gif) {
-    _gif_reset_and_play(controller->right_eye->eyelid_gif, 1, false);
+void left_eyelid_blink_once(void) {
+  perform_single_eyelid_blink(eye_controller_get_eye(0));
+}
+
+void right_eyelid_blink_once(void) {
+  perform_single_eyelid_blink(eye_controller_get_eye(1));
+}
+
+/* ==================== 视线：每帧积分的弹簧 ==================== */
+#define GAZE_MAX_STEP_US 50000  // 主循环卡顿后单步最多积分的时长
+
+/* 把弹簧当前位置写到眼球上，取整后没变化时不标记脏区 */
+static void _gaze_apply(struct eye_t *eye) {
+  int32_t x = (int32_t)lroundf(eye->gaze.x);
+  int32_t y = (int32_t)lroundf(eye->gaze.y);
+  if (lv_obj_get_style_translate_x(eye->eye_gif, 0) != x) {
+    lv_obj_set_style_translate_x(eye->eye_gif, x, 0);
   }
+  if (lv_obj_get_style_translate_y(eye->eye_gif, 0) != y) {
+    lv_obj_set_style_translate_y(eye->eye_gif, y, 0);
+  }
+}
 
-  // 两个眼皮一起恢复（确保同步）
-  if (controller->left_eye && controller->left_eye->eyelid_gif) {
-    lv_gif_resume(controller->left_eye->eyelid_gif);
+/* 每次动画定时器运行时积分一步；动画只是节拍，数值不用 */
+static void _gaze_anim_cb(lv_anim_t *a, int32_t v) {
+  struct eye_t *eye = a->var;
+  uint64_t now = eye_tick_us();
+  uint64_t dt_us = now - eye->gaze_step_us;
+  if (dt_us > GAZE_MAX_STEP_US) dt_us = GAZE_MAX_STEP_US;
+  eye->gaze_step_us = now;
+
+  // 到位后由 _gaze_reap 删除动画，不在动画自己的回调里删除
+  eye->gaze_moving = eye_gaze_step(&eye->gaze, dt_us / 1e6f);
+  _gaze_apply(eye);
+
+  // 眼皮跟随视线在同一步更新，眼球和眼皮的脏区在同一帧刷新
+  if (eye->lid_gaze_coupling != 0.0f) _lid_show(eye);
+}
+
+/* 删除已经到位的视线动画，让帧调度可以进入空闲 */
+static void _gaze_reap(eyelid_controller_t *controller) {
+  for (uint32_t i = 0; i < controller->eye_cnt; i++) {
+    struct eye_t *eye = controller->eyes[i];
+    if (!eye->gaze_moving && eye->gaze_anim) {
+      lv_anim_delete(eye, NULL);
+      eye->gaze_anim = false;
+      _lid_settle(eye);
+    }
   }
-  if (controller->right_eye && controller->right_eye->eyelid_gif) {
-    lv_gif_resume(controller->right_eye->eyelid_gif);
+}
+
+/* 立即停在 (x, y) */
+static void _gaze_reset(struct eye_t *eye, int32_t x, int32_t y) {
+  lv_anim_delete(eye, NULL);
+  eye->gaze_anim = false;
+  eye->gaze_moving = false;
+  eye_gaze_reset(&eye->gaze, x, y);
+  _gaze_apply(eye);
+  if (eye->lid_gaze_coupling != 0.0f) _lid_show(eye);
+}
+
+/* 只更新目标，弹簧在下一帧开始追随；静止时才需要启动动画 */
+static void _eye_look_at_impl(struct eye_t *eye, int32_t tx, int32_t ty) {
+  if (!eye || !eye->eye_gif) return;
+
+  _blink_gaze_trigger(eye, tx, ty);
+  eye_gaze_set_target(&eye->gaze, tx, ty);
+  eye->gaze_moving = true;
+  if (eye->gaze_anim) return;
+
+  lv_anim_t a;
+  lv_anim_init(&a);
+  lv_anim_set_var(&a, eye);
+  lv_anim_set_values(&a, 0, 1);
+  lv_anim_set_duration(&a, 1000);
+  lv_anim_set_repeat_count(&a, LV_ANIM_REPEAT_INFINITE);
+  lv_anim_set_custom_exec_cb(&a, _gaze_anim_cb);
+  eye->gaze_step_us = eye_tick_us();
+  eye->gaze_anim = lv_anim_start(&a) != NULL;
+}
+
+void eye_set_gaze_stiffness(struct eye_t *eye, float omega) {
+  if (eye) eye_gaze_set_omega(&eye->gaze, omega);
+}
+
+static void _lid_set_coupling_impl(struct eye_t *eye, float k) {
+  if (!eye) return;
+  eye->lid_gaze_coupling = k;
+  _lid_prepare(eye);
+  _lid_show(eye);
+  _lid_settle(eye);
+}
+
+/* ==================== 空闲视线 ==================== */
+static void _idle_gaze_timer_cb(lv_timer_t *timer) {
+  eyelid_controller_t *controller = lv_timer_get_user_data(timer);
+  uint64_t now = eye_tick_us();
+  float x, y;
+
+  eye_idle_gaze_event_t ev =
+      eye_idle_gaze_update(&controller->idle_gaze, now, &x, &y);
+  if (ev != EYE_IDLE_GAZE_NONE) {
+    for (uint32_t i = 0; i < controller->eye_cnt; i++) {
+      struct eye_t *eye = controller->eyes[i];
+      _eye_look_at_impl(eye, (int32_t)lroundf(x * eye->max_offset),
+                        (int32_t)lroundf(y * eye->max_offset));
+    }
+    // 扫视要立即开始运动；微扫视只有一两个像素，按空闲帧周期跑即可
+    if (ev == EYE_IDLE_GAZE_SACCADE) eye_frame_sched_kick();
   }
+
+  // 睡到下一个事件，不按固定周期轮询
+  uint64_t next = eye_idle_gaze_next_us(&controller->idle_gaze);
+  uint64_t wait_ms = next > now ? (next - now + 999) / 1000 : 1;
+  lv_timer_set_period(timer, (uint32_t)wait_ms);
 }
 
-void left_eyelid_blink_once(void) {
-  if (g_eyelid_controller.left_eye &&
-      g_eyelid_controller.left_eye->eyelid_gif) {
-    perform_single_eyelid_blink(g_eyelid_controller.left_eye);
+/* 外部视线命令优先：空闲视线暂停，恢复后以该目标为注视点 */
+static void _idle_gaze_hold(eyelid_controller_t *controller,
+                            struct eye_t *eye, int32_t x, int32_t y) {
+  if (!controller->idle_gaze_timer || eye->max_offset <= 0) return;
+  eye_idle_gaze_hold(&controller->idle_gaze, eye_tick_us(),
+                     (float)x / eye->max_offset, (float)y / eye->max_offset);
+}
+
+void eye_controller_set_idle_gaze(bool enable,
+                                  const eye_idle_gaze_config_t *cfg) {
+  eyelid_controller_t *controller = &g_eyelid_controller;
+
+  if (!enable) {
+    if (controller->idle_gaze_timer) lv_timer_delete(controller->idle_gaze_timer);
+    controller->idle_gaze_timer = NULL;
+    return;
+  }
+
+  eye_idle_gaze_init(&controller->idle_gaze, cfg, eye_tick_us());
+  if (!controller->idle_gaze_timer) {
+    controller->idle_gaze_timer =
+        lv_timer_create(_idle_gaze_timer_cb, 1, controller);
   }
 }
 
-void right_eyelid_blink_once(void) {
-  if (g_eyelid_controller.right_eye &&
-      g_eyelid_controller.right_eye->eyelid_gif) {
-    perform_single_eyelid_blink(g_eyelid_controller.right_eye);
+/* ==================== 双眼注视点 ==================== */
+/* 注视点换算成左右眼的偏移，同一次调用里设置，保证同一帧生效 */
+static void _look_at_point_impl(eyelid_controller_t *controller, float x,
+                                float y, float z) {
+  uint32_t cnt = controller->eye_cnt < 2 ? controller->eye_cnt : 2;
+  float sx = 0.0f, sy = 0.0f;
+  uint32_t n = 0;
+
+  for (uint32_t i = 0; i < cnt; i++) {
+    struct eye_t *eye = controller->eyes[i];
+    float ox, oy;
+    eye_vergence_offset(&controller->vergence, i, (float)eye->max_offset, x, y,
+                        z, &ox, &oy);
+    _eye_look_at_impl(eye, (int32_t)lroundf(ox), (int32_t)lroundf(oy));
+    if (eye->max_offset > 0) {
+      sx += ox / eye->max_offset;
+      sy += oy / eye->max_offset;
+      n++;
+    }
+  }
+
+  // 双眼共用一个空闲注视点，取两眼方向的中点，不偏向后处理的那只眼
+  if (n && controller->idle_gaze_timer) {
+    eye_idle_gaze_hold(&controller->idle_gaze, eye_tick_us(), sx / n, sy / n);
   }
 }
 
-/* ==================== 视线追随函数保持不变 ==================== */
-static void look_at_anim_x(void *obj, int32_t v) {
-  lv_obj_set_style_translate_x(obj, v, 0);
+void eye_controller_set_vergence(const eye_vergence_config_t *cfg) {
+  g_eyelid_controller.vergence = *cfg;
 }
 
-static void look_at_anim_y(void *obj, int32_t v) {
-  lv_obj_set_style_translate_y(obj, v, 0);
+/* ==================== 时间线 ==================== */
+static void _timeline_gaze(uint32_t eye_idx, int32_t x, int32_t y,
+                           void *user_data) {
+  eyelid_controller_t *controller = user_data;
+  if (eye_idx >= controller->eye_cnt) return;
+  _idle_gaze_hold(controller, controller->eyes[eye_idx], x, y);
+  _eye_look_at_impl(controller->eyes[eye_idx], x, y);
 }
-static pthread_mutex_t g_anim_mutex = PTHREAD_MUTEX_INITIALIZER;
-static pthread_mutex_t g_switch_mutex = PTHREAD_MUTEX_INITIALIZER;
 
-static void _eye_look_at_impl(struct eye_t *eye, int32_t tx, int32_t ty) {
-  if (!eye || !eye->eye_gif) return;
+static void _timeline_get_gaze(uint32_t eye_idx, float *x, float *y,
+                               void *user_data) {
+  eyelid_controller_t *controller = user_data;
+  *x = controller->eyes[eye_idx]->gaze.tx;
+  *y = controller->eyes[eye_idx]->gaze.ty;
+}
+
+static void _timeline_event(const eye_timeline_key_t *key, const char *name,
+                            void *user_data) {
+  eyelid_controller_t *controller = user_data;
+
+  switch (key->op) {
+    case EYE_TIMELINE_OP_POINT:
+      _look_at_point_impl(controller, (float)key->arg[0], (float)key->arg[1],
+                          (float)key->arg[2]);
+      break;
+    case EYE_TIMELINE_OP_BLINK_ONCE:
+      eyelid_blink_once();
+      break;
+    case EYE_TIMELINE_OP_BLINK:
+      _eyelid_blink_impl((uint32_t)key->arg[0], key->arg[1]);
+      break;
+    case EYE_TIMELINE_OP_EMOTION:
+      if (eye_switch_emotion(name) < 0) {
+        printf("eye timeline: cannot switch to emotion %s\n", name);
+      }
+      break;
+    case EYE_TIMELINE_OP_LID:
+      for (uint32_t i = 0; i < controller->eye_cnt; i++) {
+        if (key->eye != EYE_TIMELINE_EYE_ALL && key->eye != i) continue;
+        _lid_set_openness_impl(controller->eyes[i], (uint32_t)key->arg[0],
+                               (uint32_t)key->arg[1]);
+      }
+      break;
+  }
+}
+
+static void _timeline_timer_cb(lv_timer_t *timer) {
+  eyelid_controller_t *controller = lv_timer_get_user_data(timer);
+  const eye_timeline_ops_t ops = {
+      .eye_cnt = controller->eye_cnt,
+      .gaze = _timeline_gaze,
+      .get_gaze = _timeline_get_gaze,
+      .event = _timeline_event,
+  };
+  uint64_t now = eye_tick_us();
+
+  eye_timeline_mixer_update(&controller->timelines, now, &ops, controller);
+
+  // 视线过渡中每帧推进，否则睡到下一个关键帧
+  uint64_t next = eye_timeline_mixer_next_us(&controller->timelines, now);
+  if (next == UINT64_MAX) {
+    lv_timer_pause(timer);
+    return;
+  }
+  uint64_t wait_ms = next > now ? (next - now + 999) / 1000
+                                : eye_frame_sched_get_period_us() / 1000;
+  lv_timer_set_period(timer, wait_ms ? (uint32_t)wait_ms : 1);
+}
+
+uint32_t eye_controller_play_timeline(const eye_timeline_t *tl, float weight) {
+  eyelid_controller_t *controller = &g_eyelid_controller;
+  uint32_t id = ++controller->timeline_id;
+  if (id == 0) id = ++controller->timeline_id;  // 0 表示全部
+
+  if (!eye_timeline_mixer_play(&controller->timelines, tl, id, weight,
+                               eye_tick_us())) {
+    printf("eye timeline: too many timelines playing\n");
+    return 0;
+  }
 
-  int32_t x = tx;
-  int32_t y = ty;
-  if (x > eye->max_offset) x = eye->max_offset;
-  if (x < -eye->max_offset) x = -eye->max_offset;
-  if (y > eye->max_offset) y = eye->max_offset;
-  if (y < -eye->max_offset) y = -eye->max_offset;
-
-  pthread_mutex_lock(&g_anim_mutex);
-  /* X 轴动画 */
-  lv_anim_t ax;
-  lv_anim_init(&ax);
-  lv_anim_set_var(&ax, eye->eye_gif);
-  lv_anim_set_values(&ax, lv_obj_get_style_translate_x(eye->eye_gif, 0), x);
-  lv_anim_set_exec_cb(&ax, look_at_anim_x);
-  lv_anim_set_time(&ax, 100);
-  lv_anim_set_path_cb(&ax, lv_anim_path_linear);
-  lv_anim_start(&ax);
-
-  /* Y 轴动画 */
-  lv_anim_t ay;
-  lv_anim_init(&ay);
-  lv_anim_set_var(&ay, eye->eye_gif);
-  lv_anim_set_values(&ay, lv_obj_get_style_translate_y(eye->eye_gif, 0), y);
-  lv_anim_set_exec_cb(&ay, look_at_anim_y);
-  lv_anim_set_time(&ay, 100);
-  lv_anim_set_path_cb(&ay, lv_anim_path_linear);
-  lv_anim_start(&ay);
-  pthread_mutex_unlock(&g_anim_mutex);
-}
-
-typedef struct {
-  struct eye_t *eye;
-  int32_t x;
-  int32_t y;
-} look_at_data_t;
-
-static void _eye_look_at_async_cb(void *user_data) {
-  look_at_data_t *data = (look_at_data_t *)user_data;
-  if (data) {
-    _eye_look_at_impl(data->eye, data->x, data->y);
-    free(data);
+  if (!controller->timeline_timer) {
+    controller->timeline_timer =
+        lv_timer_create(_timeline_timer_cb, 1, controller);
   }
+  lv_timer_resume(controller->timeline_timer);
+  lv_timer_ready(controller->timeline_timer);  // 第一个关键帧在本帧生效
+  eye_frame_sched_kick();
+  return id;
 }
 
+void eye_controller_stop_timeline(uint32_t id) {
+  eye_timeline_mixer_stop(&g_eyelid_controller.timelines, id);
+}
+
+bool eye_controller_timeline_playing(uint32_t id) {
+  return eye_timeline_mixer_playing(&g_eyelid_controller.timelines, id);
+}
+
+/* 每只眼只保留最新的视线目标，信箱已有目标时不必再次唤醒 */
 void eye_look_at(struct eye_t *eye, int32_t tx, int32_t ty) {
-  look_at_data_t *data = (look_at_data_t *)malloc(sizeof(look_at_data_t));
-  if (data) {
-    data->eye = eye;
-    data->x = tx;
-    data->y = ty;
-    if (lv_async_call(_eye_look_at_async_cb, data) != LV_RES_OK) {
-      free(data);
-    }
+  if (!eye) return;
+  if (eye_cmd_queue_post_gaze(eye->idx, tx, ty)) _wake_render();
+}
+
+static int16_t _point_mm(float v) {
+  if (v > INT16_MAX) return INT16_MAX;
+  if (v < INT16_MIN) return INT16_MIN;
+  return (int16_t)lroundf(v);
+}
+
+/* 注视点同样只保留最新的一个 */
+void eyes_look_at_point(float x, float y, float z) {
+  if (eye_cmd_queue_post_point(_point_mm(x), _point_mm(y), _point_mm(z))) {
+    _wake_render();
   }
 }
 
 // 保持独立控制眼球的函数
 void left_eye_look_at(int32_t tx, int32_t ty) {
-  eyelid_controller_t *controller = &g_eyelid_controller;
-  if (controller->left_eye) {
-    eye_look_at(controller->left_eye, tx, ty);
-  }
+  struct eye_t *eye = eye_controller_get_eye(0);
+  if (eye) eye_look_at(eye, tx, ty);
 }
 
 void right_eye_look_at(int32_t tx, int32_t ty) {
-  eyelid_controller_t *controller = &g_eyelid_controller;
-  if (controller->right_eye) {
-    eye_look_at(controller->right_eye, tx, ty);
-  }
+  struct eye_t *eye = eye_controller_get_eye(1);
+  if (eye) eye_look_at(eye, tx, ty);
 }
 
 /* ==================== 3. 切换整套眼睛素材 ==================== */
-typedef struct {
-  struct eye_t *left_eye;
-  char *left_eye_gif_path;
-  char *left_eyelid_gif_path;
-  int32_t left_max_offset_px;
-  struct eye_t *right_eye;
-  char *right_eye_gif_path;
-  char *right_eyelid_gif_path;
-  int32_t right_max_offset_px;
-} switch_material_data_t;
+static void _switch_material_eye(struct eye_t *eye, const char *eye_path,
+                                 const char *eyelid_path,
+                                 int32_t max_offset_px) {
+  eyelid_controller_t *controller = &g_eyelid_controller;
 
-static void free_switch_material_data(switch_material_data_t *data) {
-  if (!data) return;
+  if (eye_path[0]) {
+    lv_gif_set_src(eye->eye_gif, eye_path);
+    eye_gif_player_attach(eye->eye_gif, &controller->eye_clock);
+  }
+  if (eyelid_path[0]) {
+    // 开度保持不变，在新素材的帧表上重新显示
+    _lid_anim_stop(eye);
+    eye_gif_frames_free(&eye->lid_frames);
+    eye_layer_cache_invalidate(&eye->layer_cache);
+    lv_gif_set_src(eye->eyelid_gif, eyelid_path);
+    eye_gif_player_attach(eye->eyelid_gif, &eye->lid_clock);
+  }
 
-  if (data->left_eye_gif_path) free(data->left_eye_gif_path);
-  if (data->left_eyelid_gif_path) free(data->left_eyelid_gif_path);
-  if (data->right_eye_gif_path) free(data->right_eye_gif_path);
-  if (data->right_eyelid_gif_path) free(data->right_eyelid_gif_path);
+  // 新素材从正中开始
+  eye->max_offset = max_offset_px;
+  eye->gaze.max_offset = (float)max_offset_px;
+  _gaze_reset(eye, 0, 0);
 
-  free(data);
+  _lid_prepare(eye);
+  _lid_show(eye);
+  _lid_settle(eye);
 }
 
-static void _switch_material_async(void *user_data) {
-  switch_material_data_t *data = user_data;
-
-  if (!data || !(data->left_eye && data->right_eye)) return;
-  pthread_mutex_lock(&g_switch_mutex);
+static void _switch_material_impl(const eye_cmd_t *cmd) {
+  if (!(cmd->material.eyes[0] && cmd->material.eyes[1])) return;
 
   eyelid_controller_t *controller = &g_eyelid_controller;
-  controller->waiting_for_sync = false;
-  controller->left_finished = false;
-  controller->right_finished = false;
+  _eyelid_pause_all(controller);
 
   // 现在已经处于 LVGL 主线程，安全操作
-  if (data->left_eye) {
-    if (data->left_eye_gif_path) {
-      lv_gif_pause(data->left_eye->eye_gif);
-      lv_gif_set_src(data->left_eye->eye_gif, data->left_eye_gif_path);
-      lv_obj_set_style_translate_x(data->left_eye->eye_gif, 0, 0);
-      lv_obj_set_style_translate_y(data->left_eye->eye_gif, 0, 0);
-      lv_gif_restart(data->left_eye->eye_gif);
-    }
-    if (data->left_eyelid_gif_path) {
-      lv_gif_pause(data->left_eye->eyelid_gif);
-      lv_gif_set_src(data->left_eye->eyelid_gif, data->left_eyelid_gif_path);
-      lv_gif_restart(data->left_eye->eyelid_gif);
-      lv_gif_pause(data->left_eye->eyelid_gif);
-    }
-
-    data->left_eye->max_offset = data->left_max_offset_px;
-    eye_look_at(data->left_eye, 0, 0);
+  for (uint32_t i = 0; i < 2; i++) {
+    _switch_material_eye(cmd->material.eyes[i], cmd->material.eye_path[i],
+                         cmd->material.eyelid_path[i],
+                         cmd->material.max_offset_px[i]);
   }
 
-  if (data->right_eye) {
-    if (data->right_eye_gif_path) {
-      lv_gif_pause(data->right_eye->eye_gif);
-      lv_gif_set_src(data->right_eye->eye_gif, data->right_eye_gif_path);
-      lv_obj_set_style_translate_x(data->right_eye->eye_gif, 0, 0);
-      lv_obj_set_style_translate_y(data->right_eye->eye_gif, 0, 0);
-      lv_gif_restart(data->right_eye->eye_gif);
-    }
-    if (data->right_eyelid_gif_path) {
-      lv_gif_pause(data->right_eye->eyelid_gif);
-      lv_gif_set_src(data->right_eye->eyelid_gif, data->right_eyelid_gif_path);
-      lv_gif_restart(data->right_eye->eyelid_gif);
-      lv_gif_pause(data->right_eye->eyelid_gif);
-    }
+  // 新素材的眼球从同一时刻开始播放
+  eye_anim_clock_restart(&controller->eye_clock);
+}
 
-    data->right_eye->max_offset = data->right_max_offset_px;
-    eye_look_at(data->right_eye, 0, 0);
+/* 路径拷贝进命令；过长的路径无法放进定长命令 */
+static bool _copy_path(char *dst, const char *src) {
+  if (!src) {
+    dst[0] = '\0';
+    return true;
   }
-  pthread_mutex_unlock(&g_switch_mutex);
-
-  free_switch_material_data(data);
+  if (strlen(src) >= EYE_CMD_PATH_MAX) {
+    printf("eye: material path too long: %s\n", src);
+    return false;
+  }
+  strcpy(dst, src);
+  return true;
 }
 
 void eye_switch_material(struct eye_t *left_eye, struct eye_t *right_eye,
@@ -454,29 +821,127 @@ void eye_switch_material(struct eye_t *left_eye, struct eye_t *right_eye,
                          const char *right_eye_gif_path,
                          const char *right_eyelid_gif_path,
                          int32_t right_max_offset_px) {
-  // 必须异步投递到 LVGL 主线程
-  switch_material_data_t *data = malloc(sizeof(*data));
-  if (!data) return;
-
-  data->left_eye = left_eye;
-  data->left_eye_gif_path = calloc(1, strlen(left_eye_gif_path) + 1);
-  strncpy(data->left_eye_gif_path, left_eye_gif_path,
-          strlen(left_eye_gif_path));
-  data->left_eyelid_gif_path = calloc(1, strlen(left_eyelid_gif_path) + 1);
-  strncpy(data->left_eyelid_gif_path, left_eyelid_gif_path,
-          strlen(left_eyelid_gif_path));
-  data->left_max_offset_px = left_max_offset_px;
-
-  data->right_eye = right_eye;
-  data->right_eye_gif_path = calloc(1, strlen(right_eye_gif_path) + 1);
-  strncpy(data->right_eye_gif_path, right_eye_gif_path,
-          strlen(right_eye_gif_path));
-  data->right_eyelid_gif_path = calloc(1, strlen(right_eyelid_gif_path) + 1);
-  strncpy(data->right_eyelid_gif_path, right_eyelid_gif_path,
-          strlen(right_eyelid_gif_path));
-  data->right_max_offset_px = right_max_offset_px;
-
-  lv_async_call(_switch_material_async, data);
+  // 必须投递到 LVGL 主线程
+  eye_cmd_t cmd = {.type = EYE_CMD_SWITCH_MATERIAL};
+  cmd.material.eyes[0] = left_eye;
+  cmd.material.eyes[1] = right_eye;
+  cmd.material.max_offset_px[0] = left_max_offset_px;
+  cmd.material.max_offset_px[1] = right_max_offset_px;
+  if (!_copy_path(cmd.material.eye_path[0], left_eye_gif_path) ||
+      !_copy_path(cmd.material.eyelid_path[0], left_eyelid_gif_path) ||
+      !_copy_path(cmd.material.eye_path[1], right_eye_gif_path) ||
+      !_copy_path(cmd.material.eyelid_path[1], right_eyelid_gif_path)) {
+    return;
+  }
+  _post_cmd(&cmd);
+}
+
+void eye_controller_set_emotion_dir(const char *dir, uint32_t max_offset_px) {
+  eyelid_controller_t *controller = &g_eyelid_controller;
+  controller->emotion_dir[0] = '\0';
+  if (dir) _copy_path(controller->emotion_dir, dir);
+  controller->emotion_max_offset = max_offset_px;
+}
+
+/* 切换到素材目录中名为 name 的表情 */
+int eye_switch_emotion(const char *name) {
+  static const char *const fmt[4] = {"%s/leye_%s.gif", "%s/leyelid_%s.gif",
+                                     "%s/reye_%s.gif", "%s/reyelid_%s.gif"};
+  eyelid_controller_t *controller = &g_eyelid_controller;
+  char paths[4][EYE_CMD_PATH_MAX];
+
+  if (!controller->emotion_dir[0] || controller->eye_cnt < 2) return -ENOTSUP;
+  if (name[0] == '\0' || strchr(name, '/')) return -EINVAL;
+  for (uint32_t i = 0; i < 4; i++) {
+    int n = snprintf(paths[i], sizeof(paths[i]), fmt[i],
+                     controller->emotion_dir, name);
+    if (n < 0 || n >= (int)sizeof(paths[i])) return -ENAMETOOLONG;
+  }
+
+  // 缺少素材时不切换，否则 lv_gif_set_src 失败后眼睛一片空白
+  for (uint32_t i = 0; i < 4; i++) {
+    lv_fs_file_t f;
+    if (lv_fs_open(&f, paths[i], LV_FS_MODE_RD) != LV_FS_RES_OK) {
+      return -ENOENT;
+    }
+    lv_fs_close(&f);
+  }
+
+  int32_t max_offset = (int32_t)controller->emotion_max_offset;
+  eye_switch_material(controller->eyes[0], controller->eyes[1], paths[0],
+                      paths[1], max_offset, paths[2], paths[3], max_offset);
+  return 0;
+}
+
+/* 渲染线程执行一条命令 */
+static void _cmd_handler(const eye_cmd_t *cmd, void *user_data) {
+  eyelid_controller_t *controller = user_data;
+
+  switch (cmd->type) {
+    case EYE_CMD_GAZE:
+      if (cmd->gaze.eye_idx < controller->eye_cnt) {
+        struct eye_t *eye = controller->eyes[cmd->gaze.eye_idx];
+        _idle_gaze_hold(controller, eye, cmd->gaze.x, cmd->gaze.y);
+        _eye_look_at_impl(eye, cmd->gaze.x, cmd->gaze.y);
+      }
+      break;
+    case EYE_CMD_LOOK_AT_POINT:
+      _look_at_point_impl(controller, cmd->point.x, cmd->point.y,
+                          cmd->point.z);
+      break;
+    case EYE_CMD_BLINK:
+      _eyelid_blink_impl(cmd->blink.interval_ms, cmd->blink.count);
+      break;
+    case EYE_CMD_BLINK_NATURAL:
+      _eyelid_blink_natural_impl(
+          cmd->blink_natural.use_default ? NULL : &cmd->blink_natural.cfg);
+      break;
+    case EYE_CMD_SWITCH_MATERIAL:
+      _switch_material_impl(cmd);
+      break;
+    case EYE_CMD_EYELID_OPENNESS:
+      for (uint32_t i = 0; i < controller->eye_cnt; i++) {
+        struct eye_t *eye = controller->eyes[i];
+        if (cmd->openness.eye && cmd->openness.eye != eye) continue;
+        _lid_set_openness_impl(eye, cmd->openness.pct,
+                               cmd->openness.duration_ms);
+      }
+      break;
+    case EYE_CMD_EYELID_COUPLING:
+      for (uint32_t i = 0; i < controller->eye_cnt; i++) {
+        struct eye_t *eye = controller->eyes[i];
+        if (cmd->coupling.eye && cmd->coupling.eye != eye) continue;
+        _lid_set_coupling_impl(eye, cmd->coupling.k);
+      }
+      break;
+  }
+}
+
+/* 共享内存中的新视线目标直接生效，不经过命令队列 */
+static void _gaze_shm_cb(uint32_t eye_idx, int32_t x, int32_t y,
+                         void *user_data) {
+  eyelid_controller_t *controller = user_data;
+  if (eye_idx < controller->eye_cnt) {
+    _idle_gaze_hold(controller, controller->eyes[eye_idx], x, y);
+    _eye_look_at_impl(controller->eyes[eye_idx], x, y);
+  }
+}
+
+void eye_controller_process_commands(void) {
+  _gaze_reap(&g_eyelid_controller);
+  eye_cmd_queue_drain(_cmd_handler, &g_eyelid_controller);
+
+  // 跟踪器不会唤醒主循环，读到新目标后恢复全速
+  if (g_gaze_shm &&
+      eye_gaze_shm_poll(g_gaze_shm, _gaze_shm_cb, &g_eyelid_controller)) {
+    eye_frame_sched_kick();
+  }
+}
+
+int eye_controller_open_gaze_shm(const char *name) {
+  if (g_gaze_shm) return 0;
+  g_gaze_shm = eye_gaze_shm_create(name, g_eyelid_controller.eye_cnt);
+  return g_gaze_shm ? 0 : -1;
 }
 
 static void bl_write(const char *path, const char *val) {
@@ -523,84 +988,453 @@ static void backlight_init_dual(void) {
   bl_config(12, 0, 1000000, 500000, 1);
 }
 
-uint32_t custom_tick_get(void) {
-  static uint64_t start_ms = 0;
-  if (start_ms == 0) {
-    struct timeval tv_start;
-    gettimeofday(&tv_start, NULL);
-    start_ms = (tv_start.tv_sec * 1000000 + tv_start.tv_usec) / 1000;
+static void print_fbdev_mode(const char *name, lv_display_t *disp) {
+  printf("eye: %s %s%s, %u page(s)\n", name,
+         fbdev_display_get_mode(disp) == FBDEV_DISPLAY_MODE_ZERO_COPY
+             ? "zero-copy"
+             : "copy",
+         fbdev_display_is_async_flush(disp) ? " (async)" : "",
+         fbdev_display_get_page_cnt(disp));
+}
+
+/* 打印一个显示器的刷新统计：每帧平均/最大刷新耗时和写入字节数 */
+static void print_flush_stats(const char *name, struct eye_t *eye) {
+  if (!eye || !eye->disp || eye->panel_type != EYE_PANEL_FBDEV) return;
+
+  fbdev_display_stats_t st;
+  fbdev_display_get_stats(eye->disp, &st, true);
+  if (st.frame_cnt == 0) return;
+  printf("  %s: flush avg %llu us max %u us, %llu B/frame (%llu B skipped), "
+         "%llu pages/frame, %u flips\n",
+         name, (unsigned long long)(st.flush_time_us / st.frame_cnt),
+         st.flush_time_max_us,
+         (unsigned long long)(st.bytes_written / st.frame_cnt),
+         (unsigned long long)(st.bytes_skipped / st.frame_cnt),
+         (unsigned long long)(st.pages_written / st.frame_cnt), st.flip_cnt);
+  if (fbdev_display_is_async_flush(eye->disp) && st.flush_cnt > 0) {
+    printf("  %s: flush queue avg %.1f max %u, %u early presents\n", name,
+           (double)st.queue_depth_total / st.flush_cnt, st.queue_depth_max,
+           st.early_present_cnt);
   }
-  struct timeval tv_now;
-  gettimeofday(&tv_now, NULL);
-  uint64_t now_ms = (tv_now.tv_sec * 1000000 + tv_now.tv_usec) / 1000;
-  return (uint32_t)(now_ms - start_ms);
 }
 
-static void print_fps(void) {
-  static uint32_t last_fps_time = 0;
-  static uint32_t frame_counter = 0;
+/* 打印 DRM 面板的翻页统计：提交到翻页完成的延迟、渲染等待翻页的次数 */
+static void print_drm_stats(const char *name, struct eye_t *eye) {
+#if LV_USE_LINUX_DRM
+  if (!eye || !eye->disp || eye->panel_type != EYE_PANEL_DRM) return;
+
+  drm_display_stats_t st;
+  drm_display_get_stats(eye->disp, &st, true);
+  if (st.flip_cnt == 0) return;
+  printf("  %s: %u frames, %u commits, %u flips, flip latency avg %llu us max "
+         "%u us, %u render waits, %u commits skipped\n",
+         name, st.frame_cnt, st.commit_cnt, st.flip_cnt,
+         (unsigned long long)(st.flip_latency_us / st.flip_cnt),
+         st.flip_latency_max_us, st.render_wait_cnt, st.commit_skip_cnt);
+#else
+  (void)name;
+  (void)eye;
+#endif
+}
+
+/* 打印立体提交统计：左右眼翻页时间差 */
+static void print_present_stats(void) {
+  eye_present_stats_t st;
+  eye_present_get_stats(&st, true);
+  if (st.commit_cnt == 0) return;
+  printf("  present: %u commits, %u stereo, %u forced, %u vsync, skew avg %llu "
+         "us max %u us\n",
+         st.commit_cnt, st.stereo_cnt, st.forced_cnt, st.vsync_cnt,
+         (unsigned long long)(st.stereo_cnt ? st.skew_us_sum / st.stereo_cnt
+                                            : 0),
+         st.skew_us_max);
+}
+
+/* 打印命令队列统计：视线命令被合并的次数说明发送频率高于帧率 */
+static void print_cmd_stats(void) {
+  eye_cmd_stats_t st;
+  eye_cmd_queue_get_stats(&st, true);
+  if (st.push_cnt + st.drop_cnt + st.gaze_cnt == 0) return;
+  printf("  cmd: %u queued, %u dropped, %u gaze (%u coalesced), %u applied\n",
+         st.push_cnt, st.drop_cnt, st.gaze_cnt, st.coalesced_cnt,
+         st.drain_cnt);
+}
+
+/* 打印共享内存视线输入统计：跟踪器采样到渲染线程读到的延迟 */
+static void print_gaze_shm_stats(void) {
+  if (!g_gaze_shm) return;
+  eye_gaze_shm_stats_t st;
+  eye_gaze_shm_get_stats(&st, true);
+  if (st.sample_cnt == 0) return;
+  printf("  gaze shm: %u samples, latency avg %llu us max %u us, %u retries\n",
+         st.sample_cnt, (unsigned long long)(st.latency_us_sum / st.sample_cnt),
+         st.latency_us_max, st.retry_cnt);
+}
 
-  uint32_t now = lv_tick_get();
+/* 打印主循环唤醒统计 */
+static void print_loop_stats(void) {
+  eye_loop_stats_t st;
+  eye_loop_get_stats(&st, true);
+  if (st.wait_cnt == 0) return;
+  printf("  loop: %u waits, %u timer, %u command, %u fd wakeups\n",
+         st.wait_cnt, st.timer_wakeups, st.event_wakeups, st.fd_wakeups);
+}
 
-  frame_counter++;
+/* 打印一个显示器的帧调度统计：有效帧率、截止时刻抖动和错过次数 */
+static void print_frame_stats(const char *name, uint32_t idx) {
+  eye_frame_stats_t st;
+  eye_frame_sched_get_stats(idx, &st, true);
+  if (st.elapsed_us == 0) return;
+  printf("  %s: %.1f fps, jitter avg %llu us max %u us, %u missed\n", name,
+         st.frame_cnt * 1000000.0 / st.elapsed_us,
+         (unsigned long long)(st.frame_cnt ? st.jitter_us_sum / st.frame_cnt
+                                           : 0),
+         st.jitter_us_max, st.missed_cnt);
+}
 
-  // 每 500ms 更新一次 FPS 显示
-  if (now - last_fps_time >= 2000) {
-    float fps = frame_counter * 1000.0f / (now - last_fps_time);
-    printf("FPS: %.1f\n", fps);
-    frame_counter = 0;
-    last_fps_time = now;
-#if RANDOM_LOOK
-    int32_t rand_x = (rand() % 2 ? 1 : -1) *
-                     (rand() % g_eyelid_controller.left_eye->max_offset);
-    int32_t rand_y = (rand() % 2 ? 1 : -1) *
-                     (rand() % g_eyelid_controller.left_eye->max_offset);
+/* 打印一只眼各图层的 GIF 显示/跳过帧数 */
+static void print_gif_stats(const char *name, struct eye_t *eye) {
+  if (!eye) return;
 
-    eye_look_at(g_eyelid_controller.left_eye, rand_x, rand_y);
-    eye_look_at(g_eyelid_controller.right_eye, rand_x, rand_y);
+  eye_gif_player_stats_t ball, lid;
+  eye_gif_player_get_stats(eye->eye_gif, &ball, true);
+  eye_gif_player_get_stats(eye->eyelid_gif, &lid, true);
+  printf("  %s: gif eye %u shown %u dropped, eyelid %u shown %u dropped\n",
+         name, ball.shown_cnt, ball.dropped_cnt, lid.shown_cnt,
+         lid.dropped_cnt);
+}
+
+/* 周期性输出统计信息（LVGL 定时器，不占用主循环） */
+static void _stats_timer_cb(lv_timer_t *timer) {
+  eye_frame_activity_t act;
+  eye_frame_sched_get_activity(&act, true);
+  printf("eye: frame period %u us (%s), active %llu ms, idle %llu ms, "
+         "%u commands\n",
+         eye_frame_sched_get_period_us(), act.idle ? "idle" : "active",
+         (unsigned long long)(act.active_us / 1000),
+         (unsigned long long)(act.idle_us / 1000), act.kick_cnt);
+  for (uint32_t i = 0; i < g_eyelid_controller.eye_cnt; i++) {
+    struct eye_t *eye = g_eyelid_controller.eyes[i];
+    print_frame_stats(eye->name, i);
+    print_gif_stats(eye->name, eye);
+    print_flush_stats(eye->name, eye);
+    print_drm_stats(eye->name, eye);
+  }
+  print_present_stats();
+  print_loop_stats();
+  print_cmd_stats();
+  print_gaze_shm_stats();
+}
+
+/* 默认分块数：在线 CPU 数，且不超过软件绘制单元数 */
+static uint32_t _default_render_tiles(void) {
+#if RENDER_TILE_CNT > 0
+  return RENDER_TILE_CNT;
+#else
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  if (cpus < 1) cpus = 1;
+  if (cpus > LV_DRAW_SW_DRAW_UNIT_CNT) cpus = LV_DRAW_SW_DRAW_UNIT_CNT;
+  return (uint32_t)cpus;
 #endif
+}
+
+void eye_controller_set_render_tiles(uint32_t tile_cnt) {
+  eyelid_controller_t *controller = &g_eyelid_controller;
+  if (tile_cnt == 0) tile_cnt = _default_render_tiles();
+
+  // 每块是一条水平带，由不同的绘制单元并行渲染
+  for (uint32_t i = 0; i < controller->eye_cnt; i++) {
+    if (controller->eyes[i]->disp) {
+      lv_display_set_tile_cnt(controller->eyes[i]->disp, tile_cnt);
+    }
   }
 }
 
-void eye_controller_init(
-    struct eye_t *left_eye, struct eye_t *right_eye, const char *left_eye_path,
-    const char *left_eyelid_path, lv_display_rotation_t rotation_left,
-    const char *right_eye_path, const char *right_eyelid_path,
-    lv_display_rotation_t rotation_right, uint32_t max_offset_px) {
-  lv_init();
-  backlight_init_dual();
-  lv_tick_set_cb(custom_tick_get);
-
-  lv_display_t *disp0 = lv_linux_fbdev_create();
-  lv_linux_fbdev_set_file(disp0, "/dev/fb0");
-  lv_display_set_resolution(disp0, SCREEN_DIAMETER, SCREEN_DIAMETER);
-  lv_display_set_rotation(disp0, rotation_left);
-  lv_display_set_color_format(disp0, LV_COLOR_FORMAT_RGB565);
-  lv_display_set_buffers(disp0, buf00, NULL, sizeof(buf00),
-                         LV_DISPLAY_RENDER_MODE_DIRECT);
+/* 内存显示器：不输出到任何设备，只告诉 LVGL 刷新完成 */
+static void _memory_flush_cb(lv_display_t *disp, const lv_area_t *area,
+                             uint8_t *px_map) {
+  (void)area;
+  (void)px_map;
+  lv_display_flush_ready(disp);
+}
 
-  lv_display_t *disp1 = lv_linux_fbdev_create();
-  lv_linux_fbdev_set_file(disp1, "/dev/fb1");
-  lv_display_set_resolution(disp1, SCREEN_DIAMETER, SCREEN_DIAMETER);
-  lv_display_set_rotation(disp1, rotation_right);
-  lv_display_set_color_format(disp1, LV_COLOR_FORMAT_RGB565);
-  lv_display_set_buffers(disp1, buf01, NULL, sizeof(buf01),
+static void _memory_delete_event_cb(lv_event_t *e) {
+  lv_free(lv_event_get_user_data(e));
+}
+
+static lv_display_t *_memory_panel_create(const eye_panel_config_t *cfg) {
+  if (cfg->hor_res <= 0 || cfg->ver_res <= 0) return NULL;
+
+  lv_color_format_t cf = cfg->color_format != LV_COLOR_FORMAT_UNKNOWN
+                             ? cfg->color_format
+                             : LV_COLOR_FORMAT_RGB565;
+  uint32_t buf_size =
+      cfg->hor_res * cfg->ver_res * lv_color_format_get_size(cf);
+  void *buf = lv_malloc(buf_size);
+  if (!buf) return NULL;
+
+  lv_display_t *disp = lv_display_create(cfg->hor_res, cfg->ver_res);
+  if (!disp) {
+    lv_free(buf);
+    return NULL;
+  }
+  lv_display_set_color_format(disp, cf);
+  lv_display_set_rotation(disp, cfg->rotation);
+  lv_display_set_buffers(disp, buf, NULL, buf_size,
                          LV_DISPLAY_RENDER_MODE_DIRECT);
+  lv_display_set_flush_cb(disp, _memory_flush_cb);
+  lv_display_add_event_cb(disp, _memory_delete_event_cb, LV_EVENT_DELETE, buf);
+  return disp;
+}
+
+static lv_display_t *_fbdev_panel_create(const eye_panel_config_t *cfg) {
+  fbdev_display_config_t fb_cfg = {
+      .hor_res = cfg->hor_res,
+      .ver_res = cfg->ver_res,
+      .rotation = cfg->rotation,
+      .color_format = cfg->color_format,
+      .mode = cfg->buf_strategy == EYE_BUF_ZERO_COPY
+                  ? FBDEV_DISPLAY_MODE_ZERO_COPY
+                  : FBDEV_DISPLAY_MODE_COPY,
+      .page_flip = cfg->page_flip,
+      .async_flush = cfg->buf_strategy != EYE_BUF_COPY,
+      // deferred I/O 按内存页传输，未变化的页不写就不会上总线
+      .dirty_rows = cfg->deferred_io,
+      .sync_damage = cfg->deferred_io,
+  };
+
+  // 分辨率已知且放得下时使用 .fast_ram 中的缓冲区，否则由驱动分配
+  uint32_t px_size = cfg->color_format != LV_COLOR_FORMAT_UNKNOWN
+                         ? lv_color_format_get_size(cfg->color_format)
+                         : sizeof(lv_color_t);
+  if (g_fast_buf_used < FAST_BUF_CNT && cfg->hor_res > 0 && cfg->ver_res > 0 &&
+      (size_t)cfg->hor_res * cfg->ver_res * px_size <=
+          sizeof(g_fast_bufs[0])) {
+    fb_cfg.buf = g_fast_bufs[g_fast_buf_used++];
+    fb_cfg.buf_size = sizeof(g_fast_bufs[0]);
+  }
+
+  lv_display_t *disp = fbdev_display_create(cfg->path, &fb_cfg);
+  if (disp) print_fbdev_mode(cfg->path, disp);
+  return disp;
+}
+
+static lv_display_t *_drm_panel_create(const eye_panel_config_t *cfg) {
+#if LV_USE_LINUX_DRM
+  drm_display_config_t drm_cfg = {
+      .connector_id = cfg->connector_id,
+      .hor_res = cfg->hor_res,
+      .ver_res = cfg->ver_res,
+      .rotation = cfg->rotation,
+      .color_format = cfg->color_format,
+  };
+  lv_display_t *disp = drm_display_create(cfg->path, &drm_cfg);
+  if (disp) printf("eye: %s drm, atomic page flip\n", cfg->path);
+  return disp;
+#else
+  printf("eye: %s: DRM support is disabled (LV_USE_LINUX_DRM)\n", cfg->path);
+  return NULL;
+#endif
+}
+
+/* 面板刷新周期（us），无法获取时返回 0 */
+static uint32_t _panel_refresh_period_us(eye_panel_type_t type,
+                                         lv_display_t *disp) {
+  switch (type) {
+    case EYE_PANEL_FBDEV:
+      return fbdev_display_get_refresh_period_us(disp);
+#if LV_USE_LINUX_DRM
+    case EYE_PANEL_DRM:
+      return drm_display_get_refresh_period_us(disp);
+#endif
+    default:
+      return 0;
+  }
+}
+
+#if LV_USE_LINUX_DRM
+/* 翻页完成事件：处理完后把帧网格对齐到 vblank */
+static void _drm_event_cb(int fd, uint32_t events, void *user_data) {
+  lv_display_t *disp = user_data;
+  drm_display_stats_t st;
+
+  drm_display_handle_events(disp);
+  drm_display_get_stats(disp, &st, false);
+  if (st.vblank_us) {
+    eye_frame_sched_sync_vblank(eye_tick_from_monotonic_us(st.vblank_us));
+  }
+}
+#endif
+
+lv_display_t *eye_panel_create(const eye_panel_config_t *cfg) {
+  switch (cfg->type) {
+    case EYE_PANEL_FBDEV:
+      return _fbdev_panel_create(cfg);
+    case EYE_PANEL_DRM:
+      return _drm_panel_create(cfg);
+    case EYE_PANEL_MEMORY:
+      return _memory_panel_create(cfg);
+    default:
+      return NULL;
+  }
+}
+
+uint32_t eye_controller_get_eye_cnt(void) {
+  return g_eyelid_controller.eye_cnt;
+}
+
+struct eye_t *eye_controller_get_eye(uint32_t idx) {
+  if (idx >= g_eyelid_controller.eye_cnt) return NULL;
+  return g_eyelid_controller.eyes[idx];
+}
+
+void eye_controller_init_with_displays(lv_display_t *const *disps,
+                                       struct eye_t *const *eyes,
+                                       const eye_config_t *cfgs, uint32_t cnt) {
+  eyelid_controller_t *controller = &g_eyelid_controller;
+  if (cnt > EYE_MAX_CNT) cnt = EYE_MAX_CNT;
+
+  // 所有眼睛共用的动画时钟
+  eye_anim_clock_init(&controller->eye_clock, GIF_CATCHUP);
+  eye_anim_clock_init(&controller->eyelid_clock, GIF_CATCHUP);
+  eye_anim_clock_set_finished_cb(&controller->eyelid_clock,
+                                 _eyelid_sync_finished_cb, controller);
+
+  // 初始化眼睛对象并注册到控制器
+  for (uint32_t i = 0; i < cnt; i++) {
+    eye_create(disps[i], eyes[i], cfgs[i].eye_path, cfgs[i].eyelid_path,
+               cfgs[i].max_offset_px);
+    eyes[i]->name = cfgs[i].name ? cfgs[i].name : g_eye_names[i];
+    eyes[i]->panel_type = cfgs[i].panel.type;
+    eyes[i]->idx = i;
+    eye_gaze_set_omega(&eyes[i]->gaze, cfgs[i].gaze_omega);
+    controller->eyes[i] = eyes[i];
+  }
+  controller->eye_cnt = cnt;
 
-  // 初始化眼睛对象（不再创建独立定时器）
-  eye_create(disp0, left_eye, left_eye_path, left_eyelid_path, max_offset_px);
-  eye_create(disp1, right_eye, right_eye_path, right_eyelid_path,
-             max_offset_px);
+  // 之前残留的命令不再有效
+  eye_cmd_queue_reset();
 
   // 初始化眼皮控制器
-  g_eyelid_controller.left_eye = left_eye;
-  g_eyelid_controller.right_eye = right_eye;
-  g_eyelid_controller.blink_timer = NULL;
-  g_eyelid_controller.blink_interval = 0;
-  g_eyelid_controller.blink_remaining = 0;
+  controller->blink_timer = NULL;
+  controller->blink_interval = 0;
+  controller->blink_remaining = 0;
+  controller->blink_natural = false;
+
+  // 所有眼球从同一时刻开始播放
+  eye_anim_clock_restart(&controller->eye_clock);
+
+  eye_controller_set_render_tiles(0);
+
+  controller->idle_gaze_timer = NULL;
+  controller->timeline_timer = NULL;
+  eye_timeline_mixer_stop(&controller->timelines, 0);
+#if IDLE_GAZE
+  eye_controller_set_idle_gaze(true, NULL);
+#endif
 
   // 使用统一眼皮眨眼控制
-  eyelid_blink(10000, -1);  // 间隔10秒无限眨眼
+  eyelid_blink_natural(NULL);  // 随机间隔眨眼
+}
+
+int eye_controller_init_eyes(struct eye_t *const *eyes,
+                             const eye_config_t *cfgs, uint32_t cnt) {
+  lv_display_t *disps[EYE_MAX_CNT];
+  lv_display_t *fbdev_disps[EYE_MAX_CNT];
+  lv_display_t *drm_disps[EYE_MAX_CNT];
+  uint32_t fbdev_cnt = 0;
+  uint32_t drm_cnt = 0;
+  uint32_t period_us = FRAME_PERIOD_US;
+
+  if (cnt > EYE_MAX_CNT) cnt = EYE_MAX_CNT;
+
+  lv_init();
+  backlight_init_dual();
+  eye_tick_init();
+  lv_tick_set_cb(eye_tick_ms);
+
+  for (uint32_t i = 0; i < cnt; i++) {
+    disps[i] = eye_panel_create(&cfgs[i].panel);
+    if (!disps[i]) {
+      printf("eye: failed to create panel %u (%s)\n", i,
+             cfgs[i].panel.path ? cfgs[i].panel.path : "memory");
+      // 已创建的面板随显示器一起释放，是否退出由调用者决定
+      while (i-- > 0) lv_display_delete(disps[i]);
+      lv_deinit();
+      return -ENODEV;
+    }
+    if (cfgs[i].panel.type == EYE_PANEL_FBDEV) fbdev_disps[fbdev_cnt++] = disps[i];
+    if (cfgs[i].panel.type == EYE_PANEL_DRM) drm_disps[drm_cnt++] = disps[i];
+
+    // 取各面板中最长的刷新周期，保证每块面板都来得及显示
+    if (FRAME_PERIOD_US == 0) {
+      uint32_t p = _panel_refresh_period_us(cfgs[i].panel.type, disps[i]);
+      if (p > period_us) period_us = p;
+    }
+  }
+
+  // 所有 fbdev 面板的新帧统一在 vsync 后提交，DRM 面板合并为一次原子提交
+  eye_present_init(fbdev_disps, fbdev_cnt);
+  eye_present_init_drm(drm_disps, drm_cnt);
+
+  // 失败时 eye_controller_task 退回轮询
+  eye_loop_init();
+
+#if LV_USE_LINUX_DRM
+  // 翻页完成事件唤醒主循环；同一张卡的面板共用一个 fd，只注册一次
+  for (uint32_t i = 0; i < drm_cnt; i++) {
+    int fd = drm_display_get_fd(drm_disps[i]);
+    bool seen = false;
+    for (uint32_t j = 0; j < i; j++) {
+      seen |= drm_display_get_fd(drm_disps[j]) == fd;
+    }
+    if (!seen) eye_loop_add_fd(fd, EPOLLIN, _drm_event_cb, drm_disps[i]);
+  }
+#endif
+
+  // 渲染对齐到帧周期的截止时刻
+  eye_frame_sched_init(disps, cnt, period_us);
+  eye_frame_sched_set_idle_period(FRAME_IDLE_PERIOD_US);
+#if STATS_PERIOD_MS > 0
+  lv_timer_create(_stats_timer_cb, STATS_PERIOD_MS, NULL);
+#endif
+
+  eye_controller_init_with_displays(disps, eyes, cfgs, cnt);
+  return 0;
+}
+
+/* 双眼默认面板：240x240 圆屏，缓冲策略由编译宏决定 */
+static eye_panel_config_t _default_panel(const char *path,
+                                         lv_display_rotation_t rotation) {
+  eye_panel_config_t panel = {
+      .type = EYE_PANEL_FBDEV,
+      .path = path,
+      .hor_res = SCREEN_DIAMETER,
+      .ver_res = SCREEN_DIAMETER,
+      .rotation = rotation,
+      .color_format = LV_COLOR_FORMAT_UNKNOWN,
+      .buf_strategy = FBDEV_ZERO_COPY     ? EYE_BUF_ZERO_COPY
+                      : FBDEV_ASYNC_FLUSH ? EYE_BUF_COPY_ASYNC
+                                          : EYE_BUF_COPY,
+      .page_flip = FBDEV_PAGE_FLIP,
+  };
+  return panel;
+}
+
+int eye_controller_init(
+    struct eye_t *left_eye, struct eye_t *right_eye, const char *left_eye_path,
+    const char *left_eyelid_path, lv_display_rotation_t rotation_left,
+    const char *right_eye_path, const char *right_eyelid_path,
+    lv_display_rotation_t rotation_right, uint32_t max_offset_px) {
+  eye_config_t cfgs[2] = {
+      {"left", _default_panel("/dev/fb0", rotation_left), left_eye_path,
+       left_eyelid_path, max_offset_px, 0.0f},
+      {"right", _default_panel("/dev/fb1", rotation_right), right_eye_path,
+       right_eyelid_path, max_offset_px, 0.0f},
+  };
+  struct eye_t *eyes[2] = {left_eye, right_eye};
+
+  return eye_controller_init_eyes(eyes, cfgs, 2);
 }
 
 /**
@@ -609,6 +1443,13 @@ void eye_controller_init(
 void eye_destroy(struct eye_t *eye) {
   if (!eye) return;
 
+  lv_anim_delete(eye, NULL);
+  eye->gaze_anim = false;
+  lv_anim_delete(&eye->lid_frames, NULL);
+  eye_gif_frames_free(&eye->lid_frames);
+  eye_layer_cache_deinit(&eye->layer_cache);
+  eye_anim_clock_deinit(&eye->lid_clock);
+
   // 删除GIF对象
   if (eye->eye_gif) {
     lv_obj_del(eye->eye_gif);
@@ -632,31 +1473,40 @@ void eye_controller_deinit(void) {
     lv_timer_del(controller->blink_timer);
     controller->blink_timer = NULL;
   }
+  eye_controller_set_idle_gaze(false, NULL);
+  eye_timeline_mixer_stop(&controller->timelines, 0);
+  if (controller->timeline_timer) {
+    lv_timer_delete(controller->timeline_timer);
+    controller->timeline_timer = NULL;
+  }
+
+  eye_anim_clock_deinit(&controller->eye_clock);
+  eye_anim_clock_deinit(&controller->eyelid_clock);
 
   // 销毁眼睛对象
-  if (controller->left_eye) {
-    eye_destroy(controller->left_eye);
-    controller->left_eye = NULL;
-  }
-  if (controller->right_eye) {
-    eye_destroy(controller->right_eye);
-    controller->right_eye = NULL;
+  for (uint32_t i = 0; i < controller->eye_cnt; i++) {
+    eye_destroy(controller->eyes[i]);
+    controller->eyes[i] = NULL;
   }
+  controller->eye_cnt = 0;
+
+  eye_gaze_shm_detach(g_gaze_shm);
+  g_gaze_shm = NULL;
 
   // LVGL反初始化
+  eye_frame_sched_deinit();
   lv_deinit();
+  eye_loop_deinit();
+  g_fast_buf_used = 0;
 }
 
 void eye_controller_task(void) {
-  uint32_t last = lv_tick_get();
   while (1) {
-    lv_timer_handler();
-    print_fps();
+    eye_controller_process_commands();
+    uint64_t wait_us = eye_frame_sched_handler();
+    eye_present_commit();
 
-    uint32_t elaps = lv_tick_get() - last;
-    if (elaps < 5) {
-      usleep((5 - elaps) * 1000);
-    }
-    last = lv_tick_get();
+    // 睡到下一个截止时刻或定时器到期，有命令投递时立即醒来
+    eye_loop_wait_us(wait_us);
   }
 }
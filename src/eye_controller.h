@@ -1,51 +1,173 @@
 #ifndef EYE_CONTROLLER_H
 #define EYE_CONTROLLER_H
 
+#include "eye_blink_sched.h"
+#include "eye_cmd_queue.h"
+#include "eye_gif_player.h"
+#include "eye_gaze.h"
+#include "eye_idle_gaze.h"
+#include "eye_layer_cache.h"
+#include "eye_timeline.h"
+#include "eye_vergence.h"
 #include "lvgl.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#define EYE_MAX_CNT 4  // 最多支持的眼睛（面板）数
+
+/* 面板类型 */
+typedef enum {
+  EYE_PANEL_FBDEV,   // framebuffer 设备
+  EYE_PANEL_DRM,     // DRM/KMS（需开启 LV_USE_LINUX_DRM），原子提交翻页
+  EYE_PANEL_MEMORY,  // 内存显示器，不输出到设备（基准测试、无屏调试）
+} eye_panel_type_t;
+
+/* 像素写入面板的方式（仅 fbdev 使用，DRM 总是直接渲染到 dumb buffer） */
+typedef enum {
+  EYE_BUF_ZERO_COPY,   // 直接渲染到 framebuffer，条件不满足时回退为异步拷贝
+  EYE_BUF_COPY,        // 渲染到内存缓冲区，再拷贝刷新区域
+  EYE_BUF_COPY_ASYNC,  // 同上，拷贝由工作线程完成
+} eye_buf_strategy_t;
+
+/* 单个面板的配置 */
+typedef struct {
+  eye_panel_type_t type;
+  const char *path;                // 设备，如 /dev/fb0、/dev/dri/card0；fbdev 也可以是普通文件
+  uint32_t connector_id;           // DRM 连接器，0 表示下一个已连接的
+  int32_t hor_res;                 // 0 表示使用面板分辨率（内存显示器必须指定）
+  int32_t ver_res;
+  lv_display_rotation_t rotation;
+  lv_color_format_t color_format;  // LV_COLOR_FORMAT_UNKNOWN 表示保持面板格式
+  eye_buf_strategy_t buf_strategy;
+  bool page_flip;                  // 双页 + FBIOPAN_DISPLAY 翻页
+  bool deferred_io;                // SPI 等 deferred I/O 面板：拷贝时只写变化的像素，帧尾立即同步
+} eye_panel_config_t;
+
+/* 一只眼睛的配置：面板 + 素材 */
+typedef struct {
+  const char *name;          // 日志中使用的名字，NULL 时按序号命名
+  eye_panel_config_t panel;
+  const char *eye_path;      // 眼球 GIF
+  const char *eyelid_path;   // 眼皮 GIF
+  uint32_t max_offset_px;    // 视线最大偏移（圆形区域的半径）
+  float gaze_omega;          // 视线弹簧角频率（rad/s），越大越快，0 表示默认
+} eye_config_t;
+
 /* 眼睛结构体 */
 struct eye_t {
+  const char *name;      // 日志中使用的名字
+  eye_panel_type_t panel_type;
+  uint32_t idx;          // 在控制器中的序号
   lv_disp_t *disp;       // 关联的显示器
+  lv_obj_t *bg;          // 眼底背景对象
   lv_obj_t *eye_gif;     // 眼球GIF对象
   lv_obj_t *eyelid_gif;  // 眼睑GIF对象
   int32_t max_offset;    // 最大偏移量
+  eye_gaze_t gaze;       // 视线弹簧，每帧向最新目标积分
+  uint64_t gaze_step_us; // 上次积分的时刻
+  bool gaze_anim;        // 驱动积分的动画是否存在
+  bool gaze_moving;      // 弹簧尚未停在目标上
+  eye_layer_cache_t layer_cache;  // 眼底+静止眼皮的预合成缓存
+  eye_anim_clock_t lid_clock;     // 单眼眨眼时眼皮使用的动画时钟
+  eye_gif_frames_t lid_frames;    // 眼皮帧表，第一次设置开度时建立
+  float lid_open;                 // 眼皮开度，0 为闭上，1 为睁开
+  float lid_from, lid_to;         // 开度过渡的起点和终点
+  float lid_gaze_coupling;        // 视线上下移动对开度的影响，0 表示关闭
 };
 
 /* 眼皮控制器结构体 */
 typedef struct eyelid_controller_t {
-  struct eye_t *left_eye;   // 左眼指针
-  struct eye_t *right_eye;  // 右眼指针
-  
+  struct eye_t *eyes[EYE_MAX_CNT];  // 已注册的眼睛，eyes[0] 为左眼，eyes[1] 为右眼
+  uint32_t eye_cnt;
+
   lv_timer_t *blink_timer;  // 统一的眨眼定时器
   uint32_t blink_interval;  // 眨眼间隔
   int32_t blink_remaining;  // 剩余眨眼次数
+  bool blink_natural;       // 由自然眨眼调度决定眨眼时刻
+  eye_blink_sched_t blink_sched;
+
+  eye_anim_clock_t eye_clock;     // 所有眼球共用的动画时钟
+  eye_anim_clock_t eyelid_clock;  // 同步眨眼时所有眼皮共用的动画时钟
+
+  lv_timer_t *idle_gaze_timer;    // 空闲视线定时器，关闭时为 NULL
+  eye_idle_gaze_t idle_gaze;      // 所有眼睛共用一个空闲视线，双眼同向运动
+  eye_vergence_config_t vergence; // 双眼注视点的几何参数
 
-  bool left_finished;
-  bool right_finished;
-  bool waiting_for_sync;    // 当前是否有正在进行的眨眼会话
+  lv_timer_t *timeline_timer;     // 推进时间线，没有播放时暂停
+  eye_timeline_mixer_t timelines; // 播放中的时间线
+  uint32_t timeline_id;           // 上一次分配的播放 id
+
+  char emotion_dir[EYE_CMD_PATH_MAX];  // 表情素材目录，空表示不能按名切换
+  uint32_t emotion_max_offset;         // 切换表情后的视线最大偏移
 } eyelid_controller_t;
 
-/* 初始化眼睛控制器 */
-void eye_controller_init(
+/* 按配置创建一个面板显示器（需已调用 lv_init），失败返回 NULL */
+lv_display_t *eye_panel_create(const eye_panel_config_t *cfg);
+
+/*
+ * 按配置表初始化 cnt 只眼睛（最多 EYE_MAX_CNT），eyes 由调用者提供
+ * 成功返回 0；有面板创建失败时释放已创建的面板并返回 -ENODEV
+ */
+int eye_controller_init_eyes(struct eye_t *const *eyes,
+                             const eye_config_t *cfgs, uint32_t cnt);
+
+/* 初始化双眼控制器：/dev/fb0 为左眼，/dev/fb1 为右眼；返回值同上 */
+int eye_controller_init(
     struct eye_t *left_eye, struct eye_t *right_eye, const char *left_eye_path,
     const char *left_eyelid_path, lv_display_rotation_t rotation_left,
     const char *right_eye_path, const char *right_eyelid_path,
     lv_display_rotation_t rotation_right, uint32_t max_offset_px);
 
+/* 在已创建的显示器上初始化眼睛（需已调用 lv_init，用于基准测试等场景） */
+void eye_controller_init_with_displays(lv_display_t *const *disps,
+                                       struct eye_t *const *eyes,
+                                       const eye_config_t *cfgs, uint32_t cnt);
+
+/* 已注册的眼睛数 / 第 idx 只眼睛（越界返回 NULL） */
+uint32_t eye_controller_get_eye_cnt(void);
+struct eye_t *eye_controller_get_eye(uint32_t idx);
+
+/* 设置每屏并行渲染的水平分块数，0 表示自动（在线 CPU 数） */
+void eye_controller_set_render_tiles(uint32_t tile_cnt);
+
 /* 反初始化 */
 void eye_controller_deinit(void);
 
 /* 主任务循环 */
 void eye_controller_task(void);
 
-/* 同步控制两个眼皮 */
+/* 执行其它线程投递的命令（渲染线程每帧调用一次，eye_controller_task 已包含） */
+void eye_controller_process_commands(void);
+
+/* 开启共享内存视线输入（见 eye_gaze_shm.h），需在眼睛初始化之后调用；失败返回 -1 */
+int eye_controller_open_gaze_shm(const char *name);
+
+/* 同步控制所有眼皮 */
 void eyelid_blink(uint32_t interval_ms, int32_t count);
 void eyelid_blink_once(void);
 
+/*
+ * 自然眨眼（见 eye_blink_sched.h）：随机间隔、偶尔连眨、大幅视线跳动时顺带眨眼
+ * cfg 为 NULL 时使用默认参数；调用 eyelid_blink() 切回定时眨眼。线程安全
+ */
+void eyelid_blink_natural(const eye_blink_config_t *cfg);
+
+/*
+ * 眼皮开度（线程安全）：pct 为 0（闭上）~ 100（睁开），在 duration_ms 内缓动过去
+ * 开度对应眼皮 GIF 从第一帧到闭得最紧的一帧之间的某一帧；eye 为 NULL 时设置所有眼睛
+ * 眨眼时从睁开的第一帧开始播放，眨完回到设定的开度；切换素材后保持开度
+ */
+void eyelid_set_openness(struct eye_t *eye, uint32_t pct, uint32_t duration_ms);
+
+/*
+ * 眼皮跟随视线：开度在设定值的基础上减去 k * 视线纵向偏移 / max_offset，
+ * 往下看时眼皮跟着下垂，往上看时抬起（最多完全睁开）。k 为 0 时关闭
+ * 与视线在同一帧更新；eye 为 NULL 时设置所有眼睛。线程安全
+ */
+void eyelid_set_gaze_coupling(struct eye_t *eye, float k);
+
 /* 单独控制左眼皮 */
 void left_eyelid_blink(uint32_t interval_ms, int32_t count);
 void left_eyelid_blink_once(void);
@@ -54,11 +176,51 @@ void left_eyelid_blink_once(void);
 void right_eyelid_blink(uint32_t interval_ms, int32_t count);
 void right_eyelid_blink_once(void);
 
-/* 视线控制 */
+/* 视线控制（任意线程可调用，每只眼只保留最新的目标） */
 void eye_look_at(struct eye_t *eye, int32_t tx, int32_t ty);
 void left_eye_look_at(int32_t tx, int32_t ty);
 void right_eye_look_at(int32_t tx, int32_t ty);
 
+/*
+ * 双眼看向头部坐标系中的一点（mm，见 eye_vergence.h），线程安全
+ * 两只眼的偏移在渲染线程中一起算出，在同一帧生效；坐标精度 1 mm，范围 ±32 m
+ */
+void eyes_look_at_point(float x, float y, float z);
+
+/* 设置双眼注视点的几何参数（瞳距、眼球半径、面板安装角度），只能在渲染线程调用 */
+void eye_controller_set_vergence(const eye_vergence_config_t *cfg);
+
+/*
+ * 播放时间线（见 eye_timeline.h），weight 为与其它时间线混合视线时的权重（0 表示 1）
+ * 返回播放 id，没有空闲位置返回 0；tl 在播放结束或取消之前必须有效
+ * 只能在渲染线程调用
+ */
+uint32_t eye_controller_play_timeline(const eye_timeline_t *tl, float weight);
+
+/* 取消播放，id 为 0 时取消全部；只能在渲染线程调用 */
+void eye_controller_stop_timeline(uint32_t id);
+
+/* id 对应的时间线是否还在播放；只能在渲染线程调用 */
+bool eye_controller_timeline_playing(uint32_t id);
+
+/* 设置表情素材目录，素材名为 [lr]eye_<表情>.gif、[lr]eyelid_<表情>.gif */
+void eye_controller_set_emotion_dir(const char *dir, uint32_t max_offset_px);
+
+/*
+ * 按名切换表情素材，没有设置素材目录、名字无效或素材文件不存在时返回 -errno
+ * 检查文件用到 LVGL 文件系统，只能在渲染线程调用
+ */
+int eye_switch_emotion(const char *name);
+
+/* 设置视线弹簧的刚度（角频率，rad/s，0 表示默认），只能在渲染线程调用 */
+void eye_set_gaze_stiffness(struct eye_t *eye, float omega);
+
+/*
+ * 开启/关闭空闲视线（见 eye_idle_gaze.h），cfg 为 NULL 时使用默认参数
+ * 外部视线命令到来时自动让出，只能在渲染线程调用
+ */
+void eye_controller_set_idle_gaze(bool enable, const eye_idle_gaze_config_t *cfg);
+
 /* 素材切换 */
 void eye_switch_material(struct eye_t *left_eye, struct eye_t *right_eye,
                          const char *left_eye_gif_path,
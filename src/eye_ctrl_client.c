@@ -0,0 +1,79 @@
+#include "eye_ctrl_client.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "eye_tick.h"
+
+int eye_ctrl_client_connect(const char *path) {
+  struct sockaddr_un addr = {.sun_family = AF_UNIX};
+
+  if (strlen(path) >= sizeof(addr.sun_path)) return -1;
+  strcpy(addr.sun_path, path);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) return -1;
+  if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+static int _write_all(int fd, const uint8_t *data, size_t len) {
+  while (len > 0) {
+    ssize_t n = send(fd, data, len, MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) return -1;
+    data += n;
+    len -= (size_t)n;
+  }
+  return 0;
+}
+
+static int _read_all(int fd, uint8_t *data, size_t len) {
+  while (len > 0) {
+    ssize_t n = recv(fd, data, len, 0);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) return -1;
+    data += n;
+    len -= (size_t)n;
+  }
+  return 0;
+}
+
+int64_t eye_ctrl_client_request(int fd, const char *text,
+                                eye_ctrl_reply_t *reply) {
+  static uint32_t seq;
+  uint8_t msg[EYE_CTRL_MSG_MAX];
+  eye_ctrl_msg_hdr_t hdr = {
+      .magic = EYE_CTRL_MAGIC,
+      .version = EYE_CTRL_VERSION,
+      .seq = ++seq,
+  };
+  const char *err;
+  uint16_t cmd_cnt;
+
+  int len = eye_ctrl_parse_text(text, msg + sizeof(hdr), sizeof(msg) - sizeof(hdr),
+                                &cmd_cnt, &err);
+  if (len < 0) {
+    printf("eye ctrl: %s\n", err);
+    return -1;
+  }
+
+  hdr.cmd_cnt = cmd_cnt;
+  hdr.size = sizeof(hdr) + (uint32_t)len;
+  hdr.timestamp_us = eye_tick_us();
+  memcpy(msg, &hdr, sizeof(hdr));
+  if (_write_all(fd, msg, hdr.size) < 0 ||
+      _read_all(fd, (uint8_t *)reply, sizeof(*reply)) < 0) {
+    return -1;
+  }
+  if (reply->magic != EYE_CTRL_MAGIC || reply->seq != hdr.seq) return -1;
+
+  return (int64_t)(eye_tick_us() - reply->timestamp_us);
+}
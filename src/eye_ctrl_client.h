@@ -0,0 +1,30 @@
+#ifndef EYE_CTRL_CLIENT_H
+#define EYE_CTRL_CLIENT_H
+
+#include <stdint.h>
+
+#include "eye_ctrl_proto.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 控制客户端
+ *
+ * 供其它进程参考和 lvglsim --ctl 使用：把文本命令转换成一条二进制请求发出，
+ * 等待应答并测量往返延迟。
+ */
+
+/* 连接控制服务，失败返回 -1 */
+int eye_ctrl_client_connect(const char *path);
+
+/* 发送一条请求（文本命令，分号分隔）并等待应答；返回往返延迟（us），失败返回 -1 */
+int64_t eye_ctrl_client_request(int fd, const char *text,
+                                eye_ctrl_reply_t *reply);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EYE_CTRL_CLIENT_H */
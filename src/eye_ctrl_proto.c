@@ -0,0 +1,101 @@
+#include "eye_ctrl_proto.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "eye_parse.h"
+
+#define EYE_CTRL_LINE_MAX 256  // 一行文本命令的最大长度
+
+/* 解析一条命令，返回 NULL 表示成功，否则为错误原因 */
+static const char *_parse_cmd(char *text, eye_ctrl_cmd_t *cmd,
+                              const char **payload) {
+  char *save;
+  char *op = strtok_r(text, " \t", &save);
+  char *a = strtok_r(NULL, " \t", &save);
+  char *b = strtok_r(NULL, " \t", &save);
+  char *c = strtok_r(NULL, " \t", &save);
+  int32_t arg0, arg1;
+
+  memset(cmd, 0, sizeof(*cmd));
+  cmd->eye = EYE_CTRL_EYE_ALL;
+  *payload = NULL;
+
+  if (strcmp(op, "ping") == 0) {
+    cmd->op = EYE_CTRL_OP_PING;
+  } else if (strcmp(op, "gaze") == 0) {
+    cmd->op = EYE_CTRL_OP_GAZE;
+    if (!eye_parse_eye(a, EYE_CTRL_EYE_ALL, EYE_CTRL_EYE_ALL, &cmd->eye) ||
+        !eye_parse_int(b, &arg0) || !eye_parse_int(c, &arg1)) {
+      return "usage: gaze <eye|all> <x> <y>";
+    }
+    cmd->arg0 = arg0;
+    cmd->arg1 = arg1;
+  } else if (strcmp(op, "blink") == 0) {
+    cmd->op = EYE_CTRL_OP_BLINK;
+    if (!eye_parse_int(a, &arg0) || !eye_parse_int(b, &arg1)) {
+      return "usage: blink <interval_ms> <count>";
+    }
+    cmd->arg0 = arg0;
+    cmd->arg1 = arg1;
+  } else if (strcmp(op, "blink_once") == 0) {
+    cmd->op = EYE_CTRL_OP_BLINK_ONCE;
+  } else if (strcmp(op, "emotion") == 0) {
+    cmd->op = EYE_CTRL_OP_EMOTION;
+    if (!a || strlen(a) > EYE_CTRL_NAME_MAX) return "usage: emotion <name>";
+    cmd->len = (uint16_t)strlen(a);
+    *payload = a;
+  } else if (strcmp(op, "play") == 0) {
+    cmd->op = EYE_CTRL_OP_PLAY;
+    if (!a || strlen(a) > EYE_CTRL_NAME_MAX ||
+        (b && !eye_parse_int(b, &arg0))) {
+      return "usage: play <name> [weight%]";
+    }
+    cmd->arg0 = b ? arg0 : 0;
+    cmd->len = (uint16_t)strlen(a);
+    *payload = a;
+  } else if (strcmp(op, "stop") == 0) {
+    cmd->op = EYE_CTRL_OP_STOP;
+    if (a && strlen(a) > EYE_CTRL_NAME_MAX) return "usage: stop [name]";
+    cmd->len = a ? (uint16_t)strlen(a) : 0;
+    *payload = a;
+  } else {
+    return "unknown command";
+  }
+  return NULL;
+}
+
+int eye_ctrl_parse_text(const char *text, uint8_t *buf, size_t size,
+                        uint16_t *cmd_cnt, const char **err) {
+  char line[EYE_CTRL_LINE_MAX];
+  char *save;
+  size_t len = 0;
+
+  *cmd_cnt = 0;
+  if (strlen(text) >= sizeof(line)) {
+    *err = "line too long";
+    return -1;
+  }
+  strcpy(line, text);
+
+  for (char *part = strtok_r(line, ";", &save); part;
+       part = strtok_r(NULL, ";", &save)) {
+    eye_ctrl_cmd_t cmd;
+    const char *payload;
+
+    if (strspn(part, " \t") == strlen(part)) continue;  // 空命令
+    *err = _parse_cmd(part, &cmd, &payload);
+    if (*err) return -1;
+    if (len + sizeof(cmd) + cmd.len > size) {
+      *err = "too many commands";
+      return -1;
+    }
+    memcpy(buf + len, &cmd, sizeof(cmd));
+    if (cmd.len) memcpy(buf + len + sizeof(cmd), payload, cmd.len);
+    len += sizeof(cmd) + cmd.len;
+    (*cmd_cnt)++;
+  }
+
+  *err = NULL;
+  return (int)len;
+}
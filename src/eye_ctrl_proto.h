@@ -0,0 +1,88 @@
+#ifndef EYE_CTRL_PROTO_H
+#define EYE_CTRL_PROTO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 控制协议
+ *
+ * 其它进程通过 Unix 域流式套接字控制眼睛，有两种模式，由连接上的第一个字节决定：
+ *
+ * 二进制模式（第一个字节为 EYE_CTRL_MAGIC），字段均为本机字节序：
+ *   请求 = eye_ctrl_msg_hdr_t + cmd_cnt 条命令，
+ *          每条命令为 eye_ctrl_cmd_t，其后紧跟 len 字节的参数（目前只有表情名）
+ *   应答 = eye_ctrl_reply_t，原样带回 seq 和 timestamp_us，
+ *          客户端用自己的时钟减去 timestamp_us 即为往返延迟
+ *
+ * 文本模式（调试用，可以直接用 socat/nc 输入），一行一个请求，分号分隔多条命令：
+ *   gaze <eye|all> <x> <y>      视线，eye 为序号、left、right 或 all
+ *   blink <interval_ms> <count> 定时眨眼，count 为 -1 表示无限
+ *   blink_once                  立即眨眼一次
+ *   emotion <name>              切换表情素材
+ *   play <name> [weight%]       播放素材目录中的时间线 <name>.tl（见 eye_timeline.h）
+ *   stop [name]                 取消时间线，不带名字时取消全部
+ *   ping                        不执行任何操作，用于测量延迟
+ *   应答一行：ok <已执行命令数> <服务端耗时us> 或 err <原因>
+ */
+
+#define EYE_CTRL_MAGIC 0xE7
+#define EYE_CTRL_VERSION 1
+#define EYE_CTRL_MSG_MAX 1024   // 一条请求的最大字节数
+#define EYE_CTRL_NAME_MAX 32    // 表情名最大长度（不含结尾 0）
+#define EYE_CTRL_EYE_ALL 0xFF   // 命令作用于所有眼睛
+
+typedef enum {
+  EYE_CTRL_OP_PING = 0,
+  EYE_CTRL_OP_GAZE = 1,        // arg0 = x，arg1 = y
+  EYE_CTRL_OP_BLINK = 2,       // arg0 = interval_ms，arg1 = count
+  EYE_CTRL_OP_BLINK_ONCE = 3,
+  EYE_CTRL_OP_EMOTION = 4,     // 参数为 len 字节的表情名（不含结尾 0）
+  EYE_CTRL_OP_PLAY = 5,        // 参数为时间线名，arg0 = 混合权重（%，0 表示 100）
+  EYE_CTRL_OP_STOP = 6,        // 参数为时间线名，len 为 0 时取消全部
+} eye_ctrl_op_t;
+
+typedef struct __attribute__((packed)) {
+  uint8_t magic;               // EYE_CTRL_MAGIC
+  uint8_t version;             // EYE_CTRL_VERSION
+  uint16_t cmd_cnt;            // 命令条数
+  uint32_t size;               // 整条请求的字节数（含消息头）
+  uint32_t seq;                // 客户端序号，应答中带回
+  uint32_t reserved;
+  uint64_t timestamp_us;       // 客户端发送时刻，应答中带回
+} eye_ctrl_msg_hdr_t;
+
+typedef struct __attribute__((packed)) {
+  uint8_t op;                  // eye_ctrl_op_t
+  uint8_t eye;                 // 眼睛序号或 EYE_CTRL_EYE_ALL
+  uint16_t len;                // 紧跟其后的参数字节数
+  int32_t arg0;
+  int32_t arg1;
+} eye_ctrl_cmd_t;
+
+typedef struct __attribute__((packed)) {
+  uint8_t magic;
+  uint8_t version;
+  uint16_t applied;            // 成功执行的命令条数
+  int32_t status;              // 0 或第一条失败命令的 -errno
+  uint32_t seq;                // 请求的 seq
+  uint32_t server_us;          // 服务端从收到请求到应答的耗时
+  uint64_t timestamp_us;       // 请求的 timestamp_us
+} eye_ctrl_reply_t;
+
+/*
+ * 把文本命令（分号分隔）转换成二进制命令记录，写到 buf
+ * 返回写入的字节数，出错返回 -1 并由 err 给出原因
+ */
+int eye_ctrl_parse_text(const char *text, uint8_t *buf, size_t size,
+                        uint16_t *cmd_cnt, const char **err);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EYE_CTRL_PROTO_H */
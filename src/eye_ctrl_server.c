@@ -0,0 +1,379 @@
+#include "eye_ctrl_server.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "eye_cmd_queue.h"
+#include "eye_controller.h"
+#include "eye_loop.h"
+#include "eye_tick.h"
+#include "eye_timeline.h"
+
+typedef enum {
+  CLIENT_MODE_UNKNOWN,  // 还没收到第一个字节
+  CLIENT_MODE_BINARY,
+  CLIENT_MODE_TEXT,
+} client_mode_t;
+
+/* 播放中的时间线，id 为播放 id */
+typedef struct {
+  char name[EYE_CTRL_NAME_MAX + 1];
+  eye_timeline_t *tl;
+  uint32_t id;
+} ctrl_timeline_t;
+
+typedef struct {
+  int fd;               // -1 表示空闲
+  client_mode_t mode;
+  uint64_t recv_us;     // 最近一次收到数据的时刻
+  uint32_t len;
+  uint8_t buf[EYE_CTRL_MSG_MAX];
+} ctrl_client_t;
+
+static int g_listen_fd = -1;
+static char g_path[sizeof(((struct sockaddr_un *)0)->sun_path)];
+static eye_ctrl_server_config_t g_cfg;
+static ctrl_client_t g_clients[EYE_CTRL_MAX_CLIENTS];
+static eye_ctrl_server_stats_t g_stats;
+static ctrl_timeline_t g_timelines[EYE_CTRL_MAX_TIMELINES];
+
+static void _free_timeline(ctrl_timeline_t *t) {
+  // 和控制器在同一线程，取消后即可释放
+  if (t->id) eye_controller_stop_timeline(t->id);
+  eye_timeline_free(t->tl);
+  t->tl = NULL;
+  t->id = 0;
+}
+
+static ctrl_timeline_t *_find_timeline(const char *name) {
+  for (uint32_t i = 0; i < EYE_CTRL_MAX_TIMELINES; i++) {
+    ctrl_timeline_t *t = &g_timelines[i];
+    if (t->tl && strcmp(t->name, name) == 0) return t;
+  }
+  return NULL;
+}
+
+/*
+ * 从 asset_dir 加载名为 name 的时间线
+ * 每次都重新读取文件，改过的 .tl 下次播放即生效；播放完的时间线在这里释放
+ */
+static int _load_timeline(const char *name, ctrl_timeline_t **out) {
+  ctrl_timeline_t *slot = NULL;
+
+  for (uint32_t i = 0; i < EYE_CTRL_MAX_TIMELINES; i++) {
+    ctrl_timeline_t *t = &g_timelines[i];
+    if (t->tl && !eye_controller_timeline_playing(t->id)) _free_timeline(t);
+    if (!t->tl && !slot) slot = t;
+  }
+  if (!g_cfg.asset_dir) return -ENOENT;
+  if (!slot) return -EBUSY;
+
+  char path[EYE_CMD_PATH_MAX];
+  int n = snprintf(path, sizeof(path), "%s/%s.tl", g_cfg.asset_dir, name);
+  if (n < 0 || n >= (int)sizeof(path)) return -ENAMETOOLONG;
+  slot->tl = eye_timeline_load(path);
+  if (!slot->tl) return -ENOENT;
+  strcpy(slot->name, name);
+  slot->id = 0;
+  *out = slot;
+  return 0;
+}
+
+static int _apply_timeline(uint8_t op, const char *name, int32_t weight_pct) {
+  if (op == EYE_CTRL_OP_STOP && name[0] == '\0') {
+    eye_controller_stop_timeline(0);
+    return 0;
+  }
+  if (strchr(name, '/')) return -EINVAL;
+
+  // 再次播放同一条时间线时从头开始
+  ctrl_timeline_t *t = _find_timeline(name);
+  if (t) _free_timeline(t);
+  if (op == EYE_CTRL_OP_STOP) return 0;
+
+  int ret = _load_timeline(name, &t);
+  if (ret) return ret;
+
+  float weight = weight_pct > 0 ? weight_pct / 100.0f : 1.0f;
+  t->id = eye_controller_play_timeline(t->tl, weight);
+  if (!t->id) {
+    _free_timeline(t);
+    return -EBUSY;
+  }
+  return 0;
+}
+
+/* 执行一条命令，payload 为其后的参数 */
+static int _apply(const eye_ctrl_cmd_t *cmd, const uint8_t *payload) {
+  uint32_t eye_cnt = eye_controller_get_eye_cnt();
+
+  switch (cmd->op) {
+    case EYE_CTRL_OP_PING:
+      return 0;
+    case EYE_CTRL_OP_GAZE:
+      if (cmd->eye == EYE_CTRL_EYE_ALL) {
+        for (uint32_t i = 0; i < eye_cnt; i++) {
+          eye_look_at(eye_controller_get_eye(i), cmd->arg0, cmd->arg1);
+        }
+        return 0;
+      }
+      if (cmd->eye >= eye_cnt) return -ENODEV;
+      eye_look_at(eye_controller_get_eye(cmd->eye), cmd->arg0, cmd->arg1);
+      return 0;
+    case EYE_CTRL_OP_BLINK:
+      eyelid_blink((uint32_t)cmd->arg0, cmd->arg1);
+      return 0;
+    case EYE_CTRL_OP_BLINK_ONCE:
+      eyelid_blink_once();  // 在渲染线程中，可以直接调用
+      return 0;
+    case EYE_CTRL_OP_EMOTION:
+    case EYE_CTRL_OP_PLAY:
+    case EYE_CTRL_OP_STOP: {
+      char name[EYE_CTRL_NAME_MAX + 1];
+      if (cmd->len > EYE_CTRL_NAME_MAX) return -ENAMETOOLONG;
+      memcpy(name, payload, cmd->len);
+      name[cmd->len] = '\0';
+      if (cmd->op == EYE_CTRL_OP_EMOTION) return eye_switch_emotion(name);
+      return _apply_timeline(cmd->op, name, cmd->arg0);
+    }
+    default:
+      return -EINVAL;
+  }
+}
+
+/*
+ * 依次执行 cmds 中的 cnt 条命令，返回成功执行的条数
+ * status 为第一条失败命令的错误码；记录不完整时停止
+ */
+static uint16_t _apply_batch(const uint8_t *cmds, size_t size, uint16_t cnt,
+                             int32_t *status) {
+  uint16_t applied = 0;
+  size_t off = 0;
+
+  *status = 0;
+  for (uint16_t i = 0; i < cnt; i++) {
+    eye_ctrl_cmd_t cmd;
+    if (off + sizeof(cmd) > size) {
+      *status = -EPROTO;
+      break;
+    }
+    memcpy(&cmd, cmds + off, sizeof(cmd));  // 记录不保证对齐
+    if (off + sizeof(cmd) + cmd.len > size) {
+      *status = -EPROTO;
+      break;
+    }
+
+    int ret = _apply(&cmd, cmds + off + sizeof(cmd));
+    if (ret == 0) {
+      applied++;
+    } else if (*status == 0) {
+      *status = ret;
+    }
+    off += sizeof(cmd) + cmd.len;
+  }
+
+  g_stats.msg_cnt++;
+  g_stats.cmd_cnt += applied;
+  if (*status) g_stats.err_cnt++;
+  return applied;
+}
+
+static uint32_t _server_us(const ctrl_client_t *c) {
+  uint32_t us = (uint32_t)(eye_tick_us() - c->recv_us);
+  g_stats.server_us_sum += us;
+  if (us > g_stats.server_us_max) g_stats.server_us_max = us;
+  return us;
+}
+
+static void _send(ctrl_client_t *c, const void *data, size_t len) {
+  // 应答很短，客户端不读导致写满时直接丢弃
+  ssize_t ret = send(c->fd, data, len, MSG_NOSIGNAL | MSG_DONTWAIT);
+  (void)ret;
+}
+
+/* 处理一条二进制请求，返回消耗的字节数；数据不完整返回 0，协议错误返回 -1 */
+static int _handle_binary(ctrl_client_t *c) {
+  eye_ctrl_msg_hdr_t hdr;
+
+  if (c->len < sizeof(hdr)) return 0;
+  memcpy(&hdr, c->buf, sizeof(hdr));
+  if (hdr.magic != EYE_CTRL_MAGIC || hdr.version != EYE_CTRL_VERSION ||
+      hdr.size < sizeof(hdr) || hdr.size > EYE_CTRL_MSG_MAX) {
+    return -1;
+  }
+  if (c->len < hdr.size) return 0;
+
+  eye_ctrl_reply_t reply = {
+      .magic = EYE_CTRL_MAGIC,
+      .version = EYE_CTRL_VERSION,
+      .seq = hdr.seq,
+      .timestamp_us = hdr.timestamp_us,
+  };
+  int32_t status;
+  reply.applied = _apply_batch(c->buf + sizeof(hdr), hdr.size - sizeof(hdr),
+                               hdr.cmd_cnt, &status);
+  reply.status = status;
+  reply.server_us = _server_us(c);
+  _send(c, &reply, sizeof(reply));
+  return (int)hdr.size;
+}
+
+/* 处理一行文本请求，返回消耗的字节数；没有完整的一行返回 0 */
+static int _handle_text(ctrl_client_t *c) {
+  uint8_t cmds[EYE_CTRL_MSG_MAX];
+  char reply[96];
+  const char *err;
+  uint16_t cnt;
+
+  uint8_t *nl = memchr(c->buf, '\n', c->len);
+  if (!nl) return 0;
+  *nl = '\0';
+  if (nl > c->buf && nl[-1] == '\r') nl[-1] = '\0';
+
+  int len = eye_ctrl_parse_text((const char *)c->buf, cmds, sizeof(cmds), &cnt,
+                                &err);
+  if (len < 0) {
+    g_stats.err_cnt++;
+    snprintf(reply, sizeof(reply), "err %s\n", err);
+  } else {
+    int32_t status;
+    uint16_t applied = _apply_batch(cmds, (size_t)len, cnt, &status);
+    uint32_t us = _server_us(c);
+    if (status) {
+      snprintf(reply, sizeof(reply), "err %s (%u applied)\n", strerror(-status),
+               applied);
+    } else {
+      snprintf(reply, sizeof(reply), "ok %u %u\n", applied, us);
+    }
+  }
+  _send(c, reply, strlen(reply));
+  return (int)(nl - c->buf + 1);
+}
+
+static void _client_close(ctrl_client_t *c) {
+  eye_loop_remove_fd(c->fd);
+  close(c->fd);
+  c->fd = -1;
+  g_stats.client_cnt--;
+}
+
+static void _client_cb(int fd, uint32_t events, void *user_data) {
+  ctrl_client_t *c = user_data;
+
+  ssize_t n = recv(fd, c->buf + c->len, sizeof(c->buf) - c->len, MSG_DONTWAIT);
+  if (n == 0 || (n < 0 && errno != EAGAIN && errno != EINTR)) {
+    _client_close(c);
+    return;
+  }
+  if (n < 0) return;
+
+  c->recv_us = eye_tick_us();
+  c->len += (uint32_t)n;
+
+  while (c->len > 0) {
+    if (c->mode == CLIENT_MODE_UNKNOWN) {
+      c->mode = c->buf[0] == EYE_CTRL_MAGIC ? CLIENT_MODE_BINARY
+                                            : CLIENT_MODE_TEXT;
+    }
+
+    int used = c->mode == CLIENT_MODE_BINARY ? _handle_binary(c)
+                                             : _handle_text(c);
+    if (used < 0) {
+      printf("eye ctrl: protocol error, closing client\n");
+      _client_close(c);
+      return;
+    }
+    if (used == 0) break;
+    c->len -= (uint32_t)used;
+    memmove(c->buf, c->buf + used, c->len);
+  }
+
+  // 缓冲区满了还凑不出一条完整请求
+  if (c->len == sizeof(c->buf)) {
+    printf("eye ctrl: request too long, closing client\n");
+    _client_close(c);
+  }
+}
+
+static void _accept_cb(int fd, uint32_t events, void *user_data) {
+  int client_fd = accept(fd, NULL, NULL);
+  if (client_fd < 0) return;
+  fcntl(client_fd, F_SETFD, FD_CLOEXEC);
+
+  for (uint32_t i = 0; i < EYE_CTRL_MAX_CLIENTS; i++) {
+    ctrl_client_t *c = &g_clients[i];
+    if (c->fd >= 0) continue;
+    if (eye_loop_add_fd(client_fd, EPOLLIN, _client_cb, c) < 0) break;
+    c->fd = client_fd;
+    c->mode = CLIENT_MODE_UNKNOWN;
+    c->len = 0;
+    g_stats.client_cnt++;
+    return;
+  }
+
+  printf("eye ctrl: too many clients\n");
+  close(client_fd);
+}
+
+int eye_ctrl_server_init(const eye_ctrl_server_config_t *cfg) {
+  struct sockaddr_un addr = {.sun_family = AF_UNIX};
+
+  if (strlen(cfg->path) >= sizeof(addr.sun_path)) return -1;
+  strcpy(addr.sun_path, cfg->path);
+
+  g_listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (g_listen_fd < 0) goto err;
+
+  unlink(cfg->path);  // 上次异常退出留下的套接字文件
+  if (bind(g_listen_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+      listen(g_listen_fd, EYE_CTRL_MAX_CLIENTS) < 0 ||
+      eye_loop_add_fd(g_listen_fd, EPOLLIN, _accept_cb, NULL) < 0) {
+    goto err;
+  }
+
+  g_cfg = *cfg;
+  strcpy(g_path, cfg->path);
+  g_cfg.path = g_path;
+  eye_controller_set_emotion_dir(cfg->asset_dir, cfg->max_offset_px);
+  for (uint32_t i = 0; i < EYE_CTRL_MAX_CLIENTS; i++) g_clients[i].fd = -1;
+  memset(&g_stats, 0, sizeof(g_stats));
+  printf("eye ctrl: listening on %s\n", cfg->path);
+  return 0;
+
+err:
+  printf("eye ctrl: cannot listen on %s: %s\n", cfg->path, strerror(errno));
+  if (g_listen_fd >= 0) close(g_listen_fd);
+  g_listen_fd = -1;
+  return -1;
+}
+
+void eye_ctrl_server_deinit(void) {
+  if (g_listen_fd < 0) return;
+
+  for (uint32_t i = 0; i < EYE_CTRL_MAX_CLIENTS; i++) {
+    if (g_clients[i].fd >= 0) _client_close(&g_clients[i]);
+  }
+  eye_loop_remove_fd(g_listen_fd);
+  close(g_listen_fd);
+  g_listen_fd = -1;
+  unlink(g_path);
+
+  for (uint32_t i = 0; i < EYE_CTRL_MAX_TIMELINES; i++) {
+    if (g_timelines[i].tl) _free_timeline(&g_timelines[i]);
+  }
+}
+
+void eye_ctrl_server_get_stats(eye_ctrl_server_stats_t *stats, bool reset) {
+  *stats = g_stats;
+  if (reset) {
+    uint32_t client_cnt = g_stats.client_cnt;
+    memset(&g_stats, 0, sizeof(g_stats));
+    g_stats.client_cnt = client_cnt;
+  }
+}
@@ -0,0 +1,53 @@
+#ifndef EYE_CTRL_SERVER_H
+#define EYE_CTRL_SERVER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "eye_ctrl_proto.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 控制服务
+ *
+ * 在 Unix 域套接字上接受其它进程的控制命令（协议见 eye_ctrl_proto.h），
+ * 映射到 eye_controller.h 的接口。套接字注册在事件循环中，由渲染线程处理，
+ * 不需要额外的线程；一条请求中的所有命令在同一帧生效。
+ */
+
+#define EYE_CTRL_MAX_CLIENTS 4  // 同时连接的客户端数（受 EYE_LOOP_MAX_FDS 限制）
+#define EYE_CTRL_MAX_TIMELINES 8  // 同时持有的时间线个数，每次播放时重新加载
+
+typedef struct {
+  const char *path;          // 套接字路径
+  const char *asset_dir;     // 表情素材目录，素材名为 [lr]eye_<表情>.gif、[lr]eyelid_<表情>.gif，
+                             // 时间线为 <名字>.tl
+  uint32_t max_offset_px;    // 切换表情后的视线最大偏移
+} eye_ctrl_server_config_t;
+
+typedef struct {
+  uint32_t client_cnt;       // 当前连接数
+  uint32_t msg_cnt;          // 处理的请求数
+  uint32_t cmd_cnt;          // 执行的命令数
+  uint32_t err_cnt;          // 出错的请求数
+  uint64_t server_us_sum;    // 请求在服务端的耗时累计
+  uint32_t server_us_max;
+} eye_ctrl_server_stats_t;
+
+/* 启动控制服务（需在 eye_loop_init 之后调用），失败返回 -1 */
+int eye_ctrl_server_init(const eye_ctrl_server_config_t *cfg);
+
+/* 关闭所有连接并删除套接字 */
+void eye_ctrl_server_deinit(void);
+
+/* 读取统计信息 */
+void eye_ctrl_server_get_stats(eye_ctrl_server_stats_t *stats, bool reset);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EYE_CTRL_SERVER_H */
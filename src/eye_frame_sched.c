@@ -0,0 +1,237 @@
+#include "eye_frame_sched.h"
+
+#include <string.h>
+
+#include "eye_tick.h"
+
+#define EYE_FRAME_DEFAULT_PERIOD_US 16667  // 无法获取面板刷新率时按 60 Hz
+#define EYE_FRAME_REFR_TIMER_OFF UINT32_MAX  // 刷新定时器周期：实际上永不触发
+
+typedef struct {
+  lv_display_t *disp;
+  bool dirty;
+  uint64_t dirty_since_us;  // 第一次失效的时刻
+  eye_frame_stats_t stats;
+  uint64_t stats_start_us;
+} sched_disp_t;
+
+static sched_disp_t g_disps[EYE_FRAME_SCHED_MAX_DISPLAYS];
+static uint32_t g_disp_cnt;
+static uint32_t g_period_us;       // 当前帧周期
+static uint32_t g_base_period_us;  // 全速帧周期
+static uint32_t g_idle_period_us;  // 空闲帧周期，0 表示不降速
+static uint64_t g_next_deadline_us;
+
+static bool g_kick;                // 其它线程写入，用原子操作访问
+static uint64_t g_last_busy_us;
+static uint64_t g_mode_since_us;
+static eye_frame_activity_t g_activity;
+
+/*
+ * 空闲时截止时刻按空闲周期排，但这时还在失效的只有 GIF 帧：
+ * 把截止时刻提前到全速网格上的下一格，GIF 按自己的帧率显示，不被空闲周期截断
+ */
+static void _pull_in_deadline(uint64_t now) {
+  if (!g_activity.idle || g_next_deadline_us <= now) return;
+  uint64_t ahead = (g_next_deadline_us - now) / g_base_period_us;
+  g_next_deadline_us -= ahead * g_base_period_us;
+}
+
+static void _invalidate_event_cb(lv_event_t *e) {
+  sched_disp_t *sd = lv_event_get_user_data(e);
+  if (!sd->dirty) {
+    sd->dirty = true;
+    sd->dirty_since_us = eye_tick_us();
+    _pull_in_deadline(sd->dirty_since_us);
+  }
+}
+
+static bool _any_dirty(void) {
+  for (uint32_t i = 0; i < g_disp_cnt; i++) {
+    if (g_disps[i].dirty) return true;
+  }
+  return false;
+}
+
+void eye_frame_sched_init(lv_display_t *const *disps, uint32_t cnt,
+                          uint32_t period_us) {
+  if (cnt > EYE_FRAME_SCHED_MAX_DISPLAYS) cnt = EYE_FRAME_SCHED_MAX_DISPLAYS;
+
+  uint64_t now = eye_tick_us();
+  g_disp_cnt = cnt;
+  for (uint32_t i = 0; i < cnt; i++) {
+    sched_disp_t *sd = &g_disps[i];
+    memset(sd, 0, sizeof(*sd));
+    sd->disp = disps[i];
+    sd->dirty = true;  // 首帧
+    sd->dirty_since_us = now;
+    sd->stats_start_us = now;
+    // 不能 pause：lv_inv_area() 会重新 resume 刷新定时器，这里把周期设成无穷大
+    lv_timer_set_period(lv_display_get_refr_timer(disps[i]),
+                        EYE_FRAME_REFR_TIMER_OFF);
+    lv_display_add_event_cb(disps[i], _invalidate_event_cb,
+                            LV_EVENT_INVALIDATE_AREA, sd);
+  }
+
+  g_base_period_us = period_us ? period_us : EYE_FRAME_DEFAULT_PERIOD_US;
+  g_period_us = g_base_period_us;
+  g_next_deadline_us = now;
+  g_last_busy_us = now;
+  g_mode_since_us = now;
+  memset(&g_activity, 0, sizeof(g_activity));
+
+  // 动画每帧推进一次即可，不必按 LV_DEF_REFR_PERIOD 空转
+  uint32_t anim_ms = g_base_period_us / 1000;
+  lv_timer_set_period(lv_anim_get_timer(), anim_ms ? anim_ms : 1);
+}
+
+static void _set_idle(bool idle, uint64_t now) {
+  uint64_t span = now - g_mode_since_us;
+  if (g_activity.idle) {
+    g_activity.idle_us += span;
+  } else {
+    g_activity.active_us += span;
+  }
+  g_mode_since_us = now;
+  g_activity.idle = idle;
+  g_period_us = idle ? g_idle_period_us : g_base_period_us;
+}
+
+/* 根据动画和命令判断是否空闲 */
+static void _update_activity(uint64_t now) {
+  bool kick = __atomic_exchange_n(&g_kick, false, __ATOMIC_ACQ_REL);
+  if (kick) g_activity.kick_cnt++;
+  if (kick || lv_anim_count_running() > 0) g_last_busy_us = now;
+
+  if (g_idle_period_us == 0) return;
+
+  bool idle = now - g_last_busy_us >= EYE_FRAME_IDLE_DELAY_MS * 1000ull;
+  if (idle != g_activity.idle) _set_idle(idle, now);
+
+  // 命令到来时不等网格，立即渲染
+  if (kick) g_next_deadline_us = now;
+}
+
+void eye_frame_sched_set_idle_period(uint32_t idle_period_us) {
+  // 取全速周期的整数倍，空闲网格仍对齐 vblank，提前截止时刻时也落在全速网格上
+  if (idle_period_us) {
+    uint32_t n = (idle_period_us + g_base_period_us / 2) / g_base_period_us;
+    idle_period_us = (n ? n : 1) * g_base_period_us;
+  }
+  g_idle_period_us = idle_period_us;
+  if (g_activity.idle) _set_idle(idle_period_us != 0, eye_tick_us());
+}
+
+void eye_frame_sched_kick(void) {
+  __atomic_store_n(&g_kick, true, __ATOMIC_RELEASE);
+}
+
+void eye_frame_sched_get_activity(eye_frame_activity_t *activity, bool reset) {
+  uint64_t now = eye_tick_us();
+  *activity = g_activity;
+  if (activity->idle) {
+    activity->idle_us += now - g_mode_since_us;
+  } else {
+    activity->active_us += now - g_mode_since_us;
+  }
+  if (reset) {
+    g_activity.active_us = 0;
+    g_activity.idle_us = 0;
+    g_activity.kick_cnt = 0;
+    g_mode_since_us = now;
+  }
+}
+
+void eye_frame_sched_deinit(void) {
+  for (uint32_t i = 0; i < g_disp_cnt; i++) {
+    lv_display_t *disp = g_disps[i].disp;
+    lv_display_remove_event_cb_with_user_data(disp, _invalidate_event_cb,
+                                              &g_disps[i]);
+    lv_timer_set_period(lv_display_get_refr_timer(disp), LV_DEF_REFR_PERIOD);
+  }
+  lv_timer_set_period(lv_anim_get_timer(), LV_DEF_REFR_PERIOD);
+  g_disp_cnt = 0;
+  g_idle_period_us = 0;
+  g_activity.idle = false;
+}
+
+uint64_t eye_frame_sched_handler(void) {
+  uint32_t idle_ms = lv_timer_handler();
+  uint64_t now = eye_tick_us();
+
+  if (g_disp_cnt == 0) {
+    return idle_ms == LV_NO_TIMER_READY ? UINT64_MAX : (uint64_t)idle_ms * 1000;
+  }
+
+  _update_activity(now);
+
+  if (now >= g_next_deadline_us) {
+    // 定位到不晚于当前时刻的最近一个网格点
+    uint64_t slots = (now - g_next_deadline_us) / g_period_us;
+    uint64_t deadline = g_next_deadline_us + slots * g_period_us;
+
+    if (_any_dirty()) {
+      for (uint32_t i = 0; i < g_disp_cnt; i++) {
+        sched_disp_t *sd = &g_disps[i];
+        if (!sd->dirty) continue;
+
+        uint64_t start = eye_tick_us();
+        uint32_t jitter = (uint32_t)(start - deadline);
+        sd->dirty = false;
+        lv_refr_now(sd->disp);
+
+        sd->stats.frame_cnt++;
+        // 脏区等待了一个全速周期以上，说明至少错过了一个截止时刻；
+        // 没有脏区的空闲格不算错过。空闲时失效也会提前到全速网格，按全速周期计
+        sd->stats.missed_cnt += (uint32_t)((start - sd->dirty_since_us) /
+                                           g_base_period_us);
+        sd->stats.jitter_us_sum += jitter;
+        if (jitter > sd->stats.jitter_us_max) sd->stats.jitter_us_max = jitter;
+      }
+    }
+    g_next_deadline_us = deadline + g_period_us;
+    now = eye_tick_us();
+  }
+
+  // 有脏区时等到下一个截止时刻，否则只等 LVGL 定时器
+  uint64_t wait_us =
+      idle_ms == LV_NO_TIMER_READY ? UINT64_MAX : (uint64_t)idle_ms * 1000;
+  if (_any_dirty()) {
+    uint64_t to_deadline =
+        g_next_deadline_us > now ? g_next_deadline_us - now : 0;
+    if (to_deadline < wait_us) wait_us = to_deadline;
+  }
+  return wait_us;
+}
+
+uint32_t eye_frame_sched_get_period_us(void) { return g_period_us; }
+
+void eye_frame_sched_sync_vblank(uint64_t vblank_us) {
+  if (g_disp_cnt == 0) return;
+
+  uint64_t now = eye_tick_us();
+  if (vblank_us > now) vblank_us = now;
+
+  // 命令触发的立即渲染不推迟，其余截止时刻移到 vblank 之后的网格点
+  if (g_next_deadline_us > now) {
+    g_next_deadline_us =
+        vblank_us + ((now - vblank_us) / g_period_us + 1) * g_period_us;
+  }
+}
+
+void eye_frame_sched_get_stats(uint32_t idx, eye_frame_stats_t *stats,
+                               bool reset) {
+  if (idx >= g_disp_cnt) {
+    memset(stats, 0, sizeof(*stats));
+    return;
+  }
+
+  sched_disp_t *sd = &g_disps[idx];
+  uint64_t now = eye_tick_us();
+  *stats = sd->stats;
+  stats->elapsed_us = now - sd->stats_start_us;
+  if (reset) {
+    memset(&sd->stats, 0, sizeof(sd->stats));
+    sd->stats_start_us = now;
+  }
+}
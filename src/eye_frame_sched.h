@@ -0,0 +1,74 @@
+#ifndef EYE_FRAME_SCHED_H
+#define EYE_FRAME_SCHED_H
+
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define EYE_FRAME_SCHED_MAX_DISPLAYS 4  // 与 EYE_MAX_CNT 一致
+
+/*
+ * 帧调度
+ *
+ * 接管各显示器的刷新定时器：GIF 帧、视线动画等只负责标记脏区，
+ * 渲染固定在面板刷新周期的时间网格上，每个截止时刻最多渲染一次。
+ * 没有脏区时不设截止时刻，主循环只等下一个 LVGL 定时器。
+ *
+ * 自适应模式：一段时间内没有运行中的动画、也没有新命令时进入空闲，
+ * 帧周期放宽到空闲周期；收到命令立即恢复全速。空闲时只剩 GIF 帧会失效，
+ * 失效时截止时刻提前到全速网格上的下一格，GIF 帧不会因空闲周期被丢掉。
+ */
+
+#define EYE_FRAME_IDLE_DELAY_MS 300  // 无动画、无命令持续多久后进入空闲
+
+typedef struct {
+  uint32_t frame_cnt;       // 渲染帧数
+  uint32_t missed_cnt;      // 错过的截止时刻（有脏区但晚了一个全速周期以上）
+  uint64_t jitter_us_sum;   // 渲染开始时刻相对截止时刻的延迟累计
+  uint32_t jitter_us_max;   // 最大延迟
+  uint64_t elapsed_us;      // 统计时长
+} eye_frame_stats_t;
+
+typedef struct {
+  uint64_t active_us;       // 全速状态累计时长
+  uint64_t idle_us;         // 空闲状态累计时长
+  uint32_t kick_cnt;        // 命令唤醒次数
+  bool idle;                // 当前是否空闲
+} eye_frame_activity_t;
+
+/* 接管显示器刷新；period_us 为 0 时按 60 Hz */
+void eye_frame_sched_init(lv_display_t *const *disps, uint32_t cnt,
+                          uint32_t period_us);
+
+/* 恢复 LVGL 自己的刷新定时器 */
+void eye_frame_sched_deinit(void);
+
+/* 处理 LVGL 定时器，到达截止时刻且有脏区时渲染；返回距下次需要唤醒的微秒数 */
+uint64_t eye_frame_sched_handler(void);
+
+/* 当前帧周期 */
+uint32_t eye_frame_sched_get_period_us(void);
+
+/* 面板报告了翻页完成的 vblank 时刻（eye_tick_us 的时间）：把截止时刻网格对齐到 vblank */
+void eye_frame_sched_sync_vblank(uint64_t vblank_us);
+
+/* 设置空闲帧周期（取全速周期的整数倍），0 关闭自适应（始终全速） */
+void eye_frame_sched_set_idle_period(uint32_t idle_period_us);
+
+/* 有新命令：立即恢复全速并尽快渲染（线程安全） */
+void eye_frame_sched_kick(void);
+
+/* 读取全速/空闲时长统计 */
+void eye_frame_sched_get_activity(eye_frame_activity_t *activity, bool reset);
+
+/* 读取第 idx 个显示器的统计信息 */
+void eye_frame_sched_get_stats(uint32_t idx, eye_frame_stats_t *stats,
+                               bool reset);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EYE_FRAME_SCHED_H */
@@ -0,0 +1,68 @@
+#include "eye_gaze.h"
+
+#include <math.h>
+
+#define GAZE_SETTLE_PX 0.2f     // 距目标小于该值且速度足够小时视为到位
+#define GAZE_SETTLE_PX_S 2.0f
+
+/* 把 (x, y) 限制在半径为 r 的圆内 */
+static void _clamp_circle(float *x, float *y, float r) {
+  float d2 = *x * *x + *y * *y;
+  if (d2 <= r * r || d2 == 0.0f) return;
+  float s = r / sqrtf(d2);
+  *x *= s;
+  *y *= s;
+}
+
+/* 临界阻尼弹簧的解析解：p 为相对目标的位置 */
+static void _spring_axis(float *p, float *v, float omega, float dt, float e) {
+  float j = (*v + omega * *p) * dt;
+  float np = (*p + j) * e;
+  float nv = (*v - omega * j) * e;
+  *p = np;
+  *v = nv;
+}
+
+void eye_gaze_init(eye_gaze_t *gaze, float omega, float max_offset) {
+  gaze->max_offset = max_offset;
+  eye_gaze_set_omega(gaze, omega);
+  eye_gaze_reset(gaze, 0.0f, 0.0f);
+}
+
+void eye_gaze_reset(eye_gaze_t *gaze, float x, float y) {
+  _clamp_circle(&x, &y, gaze->max_offset);
+  gaze->x = gaze->tx = x;
+  gaze->y = gaze->ty = y;
+  gaze->vx = gaze->vy = 0.0f;
+}
+
+void eye_gaze_set_omega(eye_gaze_t *gaze, float omega) {
+  gaze->omega = omega > 0.0f ? omega : EYE_GAZE_DEFAULT_OMEGA;
+}
+
+void eye_gaze_set_target(eye_gaze_t *gaze, float tx, float ty) {
+  _clamp_circle(&tx, &ty, gaze->max_offset);
+  gaze->tx = tx;
+  gaze->ty = ty;
+}
+
+bool eye_gaze_step(eye_gaze_t *gaze, float dt) {
+  float px = gaze->x - gaze->tx;
+  float py = gaze->y - gaze->ty;
+  float e = expf(-gaze->omega * dt);
+
+  _spring_axis(&px, &gaze->vx, gaze->omega, dt, e);
+  _spring_axis(&py, &gaze->vy, gaze->omega, dt, e);
+  gaze->x = gaze->tx + px;
+  gaze->y = gaze->ty + py;
+
+  if (fabsf(px) < GAZE_SETTLE_PX && fabsf(py) < GAZE_SETTLE_PX &&
+      fabsf(gaze->vx) < GAZE_SETTLE_PX_S && fabsf(gaze->vy) < GAZE_SETTLE_PX_S) {
+    eye_gaze_reset(gaze, gaze->tx, gaze->ty);
+    return false;
+  }
+
+  // 带初速度改变目标时可能越过圆周，位置也要限制
+  _clamp_circle(&gaze->x, &gaze->y, gaze->max_offset);
+  return true;
+}
@@ -0,0 +1,50 @@
+#ifndef EYE_GAZE_H
+#define EYE_GAZE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 视线弹簧
+ *
+ * 每只眼一个临界阻尼弹簧，每帧按实际经过的时间向最新目标积分一步：
+ * 目标随时可以改变，位置和速度都保持连续，不会像重启线性动画那样突变；
+ * 也不会过冲。积分用解析解，步长大小不影响稳定性。
+ *
+ * 目标限制在半径为 max_offset 的圆内（而不是正方形），斜向不会超出眼眶。
+ */
+
+#define EYE_GAZE_DEFAULT_OMEGA 45.0f  // 默认角频率（rad/s），约 100 ms 走完 95%
+
+typedef struct {
+  float x, y;          // 当前位置（px）
+  float vx, vy;        // 当前速度（px/s）
+  float tx, ty;        // 目标
+  float omega;         // 角频率，越大越快
+  float max_offset;    // 目标所在圆的半径
+} eye_gaze_t;
+
+/* 初始化：静止在 (x, y)，omega 为 0 时使用默认值 */
+void eye_gaze_init(eye_gaze_t *gaze, float omega, float max_offset);
+
+/* 立即移到 (x, y) 并停止 */
+void eye_gaze_reset(eye_gaze_t *gaze, float x, float y);
+
+/* 设置刚度（角频率，rad/s），0 表示默认值 */
+void eye_gaze_set_omega(eye_gaze_t *gaze, float omega);
+
+/* 设置新目标（限制在圆内） */
+void eye_gaze_set_target(eye_gaze_t *gaze, float tx, float ty);
+
+/* 向目标积分 dt 秒；返回 false 表示已经停在目标上 */
+bool eye_gaze_step(eye_gaze_t *gaze, float dt);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EYE_GAZE_H */
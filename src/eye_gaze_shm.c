@@ -0,0 +1,142 @@
+#include "eye_gaze_shm.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define GAZE_SHM_READ_TRIES 3  // 读到写了一半的记录时的重试次数
+#define GAZE_SHM_MODE 0660     // 只允许同组的跟踪器写入
+
+static uint32_t g_last_seq[EYE_GAZE_SHM_EYES];  // 每只眼上次读到的 seq
+static uint32_t g_eye_cnt;  // 读取的眼睛数，不信任共享内存中的 eye_cnt
+static eye_gaze_shm_stats_t g_stats;
+
+uint64_t eye_gaze_shm_now_us(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+static eye_gaze_shm_t *_map(const char *name, int flags) {
+  int fd = shm_open(name, flags, GAZE_SHM_MODE);
+  if (fd < 0) return NULL;
+
+  // 复用以前按 0666 创建的共享内存时同样收紧权限
+  if ((flags & O_CREAT) && (fchmod(fd, GAZE_SHM_MODE) < 0 ||
+                            ftruncate(fd, sizeof(eye_gaze_shm_t)) < 0)) {
+    close(fd);
+    return NULL;
+  }
+
+  void *p = mmap(NULL, sizeof(eye_gaze_shm_t), PROT_READ | PROT_WRITE,
+                 MAP_SHARED, fd, 0);
+  close(fd);
+  return p == MAP_FAILED ? NULL : p;
+}
+
+eye_gaze_shm_t *eye_gaze_shm_create(const char *name, uint32_t eye_cnt) {
+  eye_gaze_shm_t *shm = _map(name, O_RDWR | O_CREAT);
+  if (!shm) {
+    printf("eye: cannot create gaze shm %s: %s\n", name, strerror(errno));
+    return NULL;
+  }
+
+  // 复用已有的共享内存时保留写方的 seq，只把已有目标当作已读
+  if (shm->magic != EYE_GAZE_SHM_MAGIC ||
+      shm->version != EYE_GAZE_SHM_VERSION) {
+    memset(shm, 0, sizeof(*shm));
+    shm->version = EYE_GAZE_SHM_VERSION;
+    __atomic_store_n(&shm->magic, EYE_GAZE_SHM_MAGIC, __ATOMIC_RELEASE);
+  }
+  g_eye_cnt = eye_cnt < EYE_GAZE_SHM_EYES ? eye_cnt : EYE_GAZE_SHM_EYES;
+  shm->eye_cnt = g_eye_cnt;
+
+  for (uint32_t i = 0; i < EYE_GAZE_SHM_EYES; i++) {
+    g_last_seq[i] = __atomic_load_n(&shm->eyes[i].seq, __ATOMIC_ACQUIRE) & ~1u;
+  }
+  memset(&g_stats, 0, sizeof(g_stats));
+  return shm;
+}
+
+eye_gaze_shm_t *eye_gaze_shm_attach(const char *name) {
+  eye_gaze_shm_t *shm = _map(name, O_RDWR);
+  if (!shm) return NULL;
+
+  if (__atomic_load_n(&shm->magic, __ATOMIC_ACQUIRE) != EYE_GAZE_SHM_MAGIC ||
+      shm->version != EYE_GAZE_SHM_VERSION) {
+    eye_gaze_shm_detach(shm);
+    return NULL;
+  }
+  return shm;
+}
+
+void eye_gaze_shm_detach(eye_gaze_shm_t *shm) {
+  if (shm) munmap(shm, sizeof(*shm));
+}
+
+void eye_gaze_shm_write(eye_gaze_shm_t *shm, uint32_t eye_idx, int32_t x,
+                        int32_t y) {
+  if (eye_idx >= EYE_GAZE_SHM_EYES) return;
+
+  eye_gaze_shm_slot_t *slot = &shm->eyes[eye_idx];
+  uint32_t seq = __atomic_load_n(&slot->seq, __ATOMIC_RELAXED);
+  uint64_t now = eye_gaze_shm_now_us();
+
+  // seq 变为奇数后才能改数据，数据写完后才能变回偶数
+  __atomic_store_n(&slot->seq, seq + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  __atomic_store_n(&slot->x, x, __ATOMIC_RELAXED);
+  __atomic_store_n(&slot->y, y, __ATOMIC_RELAXED);
+  __atomic_store_n(&slot->timestamp_us, now, __ATOMIC_RELAXED);
+  __atomic_store_n(&slot->seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+uint32_t eye_gaze_shm_poll(eye_gaze_shm_t *shm, eye_gaze_shm_cb_t cb,
+                           void *user_data) {
+  uint32_t cnt = 0;
+  uint64_t now = 0;
+
+  for (uint32_t i = 0; i < g_eye_cnt; i++) {
+    eye_gaze_shm_slot_t *slot = &shm->eyes[i];
+
+    for (uint32_t t = 0; t < GAZE_SHM_READ_TRIES; t++) {
+      uint32_t seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+      if (seq == g_last_seq[i]) break;  // 没有新目标
+      if (seq & 1) {
+        g_stats.retry_cnt++;
+        continue;
+      }
+
+      int32_t x = __atomic_load_n(&slot->x, __ATOMIC_RELAXED);
+      int32_t y = __atomic_load_n(&slot->y, __ATOMIC_RELAXED);
+      uint64_t ts = __atomic_load_n(&slot->timestamp_us, __ATOMIC_RELAXED);
+      __atomic_thread_fence(__ATOMIC_ACQUIRE);
+      if (__atomic_load_n(&slot->seq, __ATOMIC_RELAXED) != seq) {
+        g_stats.retry_cnt++;
+        continue;
+      }
+
+      g_last_seq[i] = seq;
+      if (!now) now = eye_gaze_shm_now_us();
+      uint32_t latency = now > ts ? (uint32_t)(now - ts) : 0;
+      g_stats.sample_cnt++;
+      g_stats.latency_us_sum += latency;
+      if (latency > g_stats.latency_us_max) g_stats.latency_us_max = latency;
+
+      cb(i, x, y, user_data);
+      cnt++;
+      break;
+    }
+  }
+  return cnt;
+}
+
+void eye_gaze_shm_get_stats(eye_gaze_shm_stats_t *stats, bool reset) {
+  *stats = g_stats;
+  if (reset) memset(&g_stats, 0, sizeof(g_stats));
+}
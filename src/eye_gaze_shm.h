@@ -0,0 +1,85 @@
+#ifndef EYE_GAZE_SHM_H
+#define EYE_GAZE_SHM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 共享内存视线输入
+ *
+ * 跟踪器等高频输入（30-120 Hz）直接把每只眼的最新视线目标写进一块共享内存，
+ * 不经过套接字，没有系统调用和拷贝；渲染循环每帧读一次，只取最新值。
+ *
+ * 每只眼一条记录，用 seqlock 保护：写方先把 seq 加一（变为奇数）再写数据，
+ * 写完再加一（变回偶数）；读方两次读到相同的偶数 seq 才算读到完整的数据，
+ * 否则本帧放弃，不会阻塞写方。每只眼只能有一个写方。
+ *
+ * 渲染循环空闲时不会被写方唤醒，新目标在下一帧（GIF 帧或定时器）生效，
+ * 读到新目标后恢复全速。
+ */
+
+#define EYE_GAZE_SHM_NAME "/lvglsim-gaze"  // 默认共享内存名（/dev/shm 下）
+#define EYE_GAZE_SHM_MAGIC 0x455A4147      // "GAZE"
+#define EYE_GAZE_SHM_VERSION 1
+#define EYE_GAZE_SHM_EYES 4                // 与 EYE_MAX_CNT 一致
+
+/* 一只眼的最新目标，独占一个缓存行，避免不同眼的写方互相干扰 */
+typedef struct {
+  uint32_t seq;           // 奇数表示正在写
+  int32_t x;
+  int32_t y;
+  uint32_t reserved;
+  uint64_t timestamp_us;  // 写方采样时刻（CLOCK_MONOTONIC）
+} __attribute__((aligned(64))) eye_gaze_shm_slot_t;
+
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t eye_cnt;       // 渲染进程实际的眼睛数
+  uint32_t reserved;
+  eye_gaze_shm_slot_t eyes[EYE_GAZE_SHM_EYES];
+} __attribute__((aligned(64))) eye_gaze_shm_t;
+
+typedef struct {
+  uint32_t sample_cnt;    // 读到的新目标数
+  uint32_t retry_cnt;     // 读到写了一半的记录而放弃的次数
+  uint64_t latency_us_sum;  // 写方采样到渲染线程读到的延迟累计
+  uint32_t latency_us_max;
+} eye_gaze_shm_stats_t;
+
+/* 读到新目标时的回调（渲染线程） */
+typedef void (*eye_gaze_shm_cb_t)(uint32_t eye_idx, int32_t x, int32_t y,
+                                  void *user_data);
+
+/* 读方：创建（或复用）共享内存，失败返回 NULL */
+eye_gaze_shm_t *eye_gaze_shm_create(const char *name, uint32_t eye_cnt);
+
+/* 写方：打开渲染进程创建的共享内存，失败返回 NULL */
+eye_gaze_shm_t *eye_gaze_shm_attach(const char *name);
+
+/* 解除映射（不删除共享内存） */
+void eye_gaze_shm_detach(eye_gaze_shm_t *shm);
+
+/* 写方：发布第 eye_idx 只眼的最新目标 */
+void eye_gaze_shm_write(eye_gaze_shm_t *shm, uint32_t eye_idx, int32_t x,
+                        int32_t y);
+
+/* 读方：每帧调用一次，对有新目标的眼睛调用 cb，返回新目标个数 */
+uint32_t eye_gaze_shm_poll(eye_gaze_shm_t *shm, eye_gaze_shm_cb_t cb,
+                           void *user_data);
+
+/* 读取读方统计信息 */
+void eye_gaze_shm_get_stats(eye_gaze_shm_stats_t *stats, bool reset);
+
+/* 写方使用的时间戳（CLOCK_MONOTONIC，微秒） */
+uint64_t eye_gaze_shm_now_us(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EYE_GAZE_SHM_H */
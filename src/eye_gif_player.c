@@ -0,0 +1,364 @@
+#include "eye_gif_player.h"
+
+#include <string.h>
+
+#include "eye_tick.h"
+#include "lvgl/src/libs/gif/gifdec.h"
+#include "lvgl/src/libs/gif/lv_gif_private.h"
+
+#define EYE_GIF_MIN_DELAY_US 10000  // 延时为 0 的帧按 10 ms 处理，与 lv_gif 一致
+
+typedef struct {
+  lv_obj_t *gif;
+  eye_anim_clock_t *clock;
+  uint32_t generation;    // 已对齐的时钟代数
+  uint64_t next_due_us;   // 下一帧的时钟读数
+  bool finished;          // 循环次数用完，停在最后一帧
+  bool has_loop_count;    // 回到第一帧后重新设置循环次数
+  int32_t loop_count;
+  eye_gif_player_stats_t stats;
+} gif_player_t;
+
+static gif_player_t g_players[EYE_GIF_MAX_PLAYERS];
+static uint32_t g_player_cnt;
+
+static gif_player_t *_find(const lv_obj_t *gif) {
+  for (uint32_t i = 0; i < g_player_cnt; i++) {
+    if (g_players[i].gif == gif) return &g_players[i];
+  }
+  return NULL;
+}
+
+static uint64_t _frame_delay_us(const gd_GIF *gd) {
+  uint64_t delay = (uint64_t)gd->gce.delay * 10000;
+  return delay ? delay : EYE_GIF_MIN_DELAY_US;
+}
+
+/* lv_gif 自己的帧定时器不再使用，被 lv_gif_set_src 等恢复时立即停下 */
+static void _lv_gif_timer_cb(lv_timer_t *timer) { lv_timer_pause(timer); }
+
+/* 把图层推进到时钟读数 t 应显示的帧 */
+static void _player_step(gif_player_t *p, uint64_t t) {
+  lv_gif_t *gifobj = (lv_gif_t *)p->gif;
+  uint32_t decoded = 0;
+
+  if (!gifobj->gif) return;
+
+  // 时钟重新开始：回到第一帧
+  if (p->generation != p->clock->generation) {
+    gd_rewind(gifobj->gif);  // 会把循环次数改回默认值
+    if (p->has_loop_count) lv_gif_set_loop_count(p->gif, p->loop_count);
+    p->generation = p->clock->generation;
+    p->next_due_us = 0;
+    p->finished = false;
+  }
+  if (p->finished) return;
+
+  // 中间帧只解码不渲染
+  while (t >= p->next_due_us) {
+    int has_next = gd_get_frame(gifobj->gif);
+    if (has_next == 0) {
+      p->finished = true;  // 最后一轮播放结束，画面停在最后一帧
+      break;
+    }
+    if (has_next < 0) break;
+
+    decoded++;
+    p->next_due_us += _frame_delay_us(gifobj->gif);
+    if (p->clock->catchup == EYE_GIF_CATCHUP_NONE) break;
+  }
+  if (decoded == 0) return;
+
+  const lv_image_dsc_t *dsc = lv_image_get_src(p->gif);
+  gd_render_frame(gifobj->gif, (uint8_t *)dsc->data);
+  lv_image_cache_drop(dsc);
+  lv_obj_invalidate(p->gif);
+  p->stats.shown_cnt++;
+  p->stats.dropped_cnt += decoded - 1;
+}
+
+/* 采样时钟，推进所有挂在上面的图层，并安排下次唤醒 */
+static void _clock_tick(eye_anim_clock_t *clock) {
+  uint64_t now = eye_tick_us();
+
+  // 卡顿太久：卡顿期间时钟视为停走
+  if (now > clock->wake_us + EYE_GIF_MAX_LAG_MS * 1000ull) {
+    clock->origin_us += now - clock->wake_us;
+  }
+
+  uint64_t t = now - clock->origin_us;
+  uint64_t next_due = UINT64_MAX;
+  uint32_t attached = 0;
+  bool all_finished = true;
+
+  for (uint32_t i = 0; i < g_player_cnt; i++) {
+    gif_player_t *p = &g_players[i];
+    if (p->clock != clock) continue;
+
+    _player_step(p, t);
+    attached++;
+    if (!p->finished) {
+      all_finished = false;
+      if (p->next_due_us < next_due) next_due = p->next_due_us;
+    }
+  }
+
+  // 等待结束的一方不能因为图层被换走或移除而永远等下去
+  if (all_finished && (attached > 0 || clock->finished_cb)) {
+    eye_anim_clock_pause(clock);
+    if (clock->finished_cb) clock->finished_cb(clock, clock->user_data);
+    return;
+  }
+  if (next_due == UINT64_MAX) {
+    lv_timer_pause(clock->timer);  // 没有图层在播放
+    return;
+  }
+
+  // 不追赶时，时钟最多领先最慢图层的下一帧
+  if (clock->catchup == EYE_GIF_CATCHUP_NONE && t > next_due) {
+    clock->origin_us += t - next_due;
+    t = next_due;
+  }
+
+  uint64_t wait_ms = next_due > t ? (next_due - t) / 1000 : 0;
+  if (wait_ms == 0) wait_ms = 1;
+  lv_timer_set_period(clock->timer, (uint32_t)wait_ms);
+  clock->wake_us = now + wait_ms * 1000;
+}
+
+static void _clock_timer_cb(lv_timer_t *timer) {
+  _clock_tick(lv_timer_get_user_data(timer));
+}
+
+void eye_anim_clock_init(eye_anim_clock_t *clock, eye_gif_catchup_t catchup) {
+  memset(clock, 0, sizeof(*clock));
+  clock->catchup = catchup;
+  clock->paused = true;
+  clock->timer = lv_timer_create(_clock_timer_cb, 1, clock);
+  lv_timer_pause(clock->timer);
+}
+
+void eye_anim_clock_deinit(eye_anim_clock_t *clock) {
+  if (clock->timer) lv_timer_delete(clock->timer);
+  clock->timer = NULL;
+
+  for (uint32_t i = 0; i < g_player_cnt; i++) {
+    if (g_players[i].clock == clock) g_players[i].clock = NULL;
+  }
+}
+
+void eye_anim_clock_set_finished_cb(eye_anim_clock_t *clock,
+                                    eye_anim_clock_cb_t cb, void *user_data) {
+  clock->finished_cb = cb;
+  clock->user_data = user_data;
+}
+
+void eye_anim_clock_restart(eye_anim_clock_t *clock) {
+  uint64_t now = eye_tick_us();
+  clock->origin_us = now;
+  clock->wake_us = now;
+  clock->generation++;
+  clock->paused = false;
+  lv_timer_resume(clock->timer);
+  _clock_tick(clock);  // 所有图层在同一时刻切到第一帧
+}
+
+void eye_anim_clock_pause(eye_anim_clock_t *clock) {
+  if (clock->paused) return;
+  clock->paused_us = eye_tick_us() - clock->origin_us;
+  clock->paused = true;
+  lv_timer_pause(clock->timer);
+}
+
+void eye_anim_clock_resume(eye_anim_clock_t *clock) {
+  if (!clock->paused) return;
+  uint64_t now = eye_tick_us();
+  clock->origin_us = now - clock->paused_us;
+  clock->wake_us = now;
+  clock->paused = false;
+  lv_timer_resume(clock->timer);
+  _clock_tick(clock);
+}
+
+uint64_t eye_anim_clock_get_us(const eye_anim_clock_t *clock) {
+  if (clock->paused) return clock->paused_us;
+  return eye_tick_us() - clock->origin_us;
+}
+
+static void _gif_delete_event_cb(lv_event_t *e) {
+  gif_player_t *p = _find(lv_event_get_target(e));
+  if (!p) return;
+  *p = g_players[--g_player_cnt];
+}
+
+void eye_gif_player_attach(lv_obj_t *gif, eye_anim_clock_t *clock) {
+  lv_gif_t *gifobj = (lv_gif_t *)gif;
+  gif_player_t *p = _find(gif);
+
+  if (!gif || !gifobj->timer) return;
+  if (!p) {
+    if (g_player_cnt == EYE_GIF_MAX_PLAYERS) {
+      LV_LOG_WARN("eye: too many GIF players");
+      return;
+    }
+    p = &g_players[g_player_cnt++];
+    memset(p, 0, sizeof(*p));
+    p->gif = gif;
+    lv_obj_add_event_cb(gif, _gif_delete_event_cb, LV_EVENT_DELETE, NULL);
+  }
+
+  // 画面保持 lv_gif_set_src 解码出的第一帧，时钟下次 restart 时再对齐
+  p->clock = clock;
+  p->generation = clock->generation;
+  p->next_due_us = eye_anim_clock_get_us(clock) +
+                   (gifobj->gif ? _frame_delay_us(gifobj->gif) : 0);
+  p->finished = false;
+
+  lv_timer_set_cb(gifobj->timer, _lv_gif_timer_cb);
+  lv_timer_pause(gifobj->timer);
+
+  if (!clock->paused) {
+    lv_timer_resume(clock->timer);
+    lv_timer_ready(clock->timer);
+  }
+}
+
+void eye_gif_player_set_loop_count(lv_obj_t *gif, int32_t count) {
+  gif_player_t *p = _find(gif);
+
+  lv_gif_set_loop_count(gif, count);
+  if (!p) return;
+  p->has_loop_count = true;
+  p->loop_count = count;
+}
+
+/* 画面中 alpha 过半的像素个数（ARGB8888） */
+static uint32_t _coverage(const uint8_t *data, uint32_t size) {
+  uint32_t cnt = 0;
+  for (uint32_t i = 3; i < size; i += 4) cnt += data[i] >= 0x80;
+  return cnt;
+}
+
+/*
+ * 帧表按 RGB565A8 存放（RGB565 平面后接 A8 平面），每像素 3 字节，
+ * 比画布的 ARGB8888 省四分之一；面板本身是 RGB565，颜色没有可见损失
+ */
+static void _pack_frame(uint8_t *dst, const uint8_t *argb, uint32_t px_cnt) {
+  uint16_t *rgb = (uint16_t *)dst;
+  uint8_t *alpha = dst + px_cnt * 2;
+  for (uint32_t i = 0; i < px_cnt; i++, argb += 4) {
+    // ARGB8888 在内存中依次为 B、G、R、A
+    rgb[i] = (uint16_t)(((argb[2] & 0xF8) << 8) | ((argb[1] & 0xFC) << 3) |
+                        (argb[0] >> 3));
+    alpha[i] = argb[3];
+  }
+}
+
+static void _unpack_frame(uint8_t *argb, const uint8_t *src, uint32_t px_cnt) {
+  const uint16_t *rgb = (const uint16_t *)src;
+  const uint8_t *alpha = src + px_cnt * 2;
+  for (uint32_t i = 0; i < px_cnt; i++, argb += 4) {
+    uint32_t r = rgb[i] >> 11, g = (rgb[i] >> 5) & 0x3F, b = rgb[i] & 0x1F;
+    argb[0] = (uint8_t)((b << 3) | (b >> 2));
+    argb[1] = (uint8_t)((g << 2) | (g >> 4));
+    argb[2] = (uint8_t)((r << 3) | (r >> 2));
+    argb[3] = alpha[i];
+  }
+}
+
+/*
+ * 从头解码下一帧，只播一轮：循环 GIF（NETSCAPE 循环次数 0）解码到末尾会绕回
+ * 第一帧，永远不返回 0。rewind 和读到 NETSCAPE 扩展都会改写循环次数，
+ * 所以每解一帧都重新设为 1
+ */
+static int _get_frame_once(gd_GIF *gd) {
+  gd->loop_count = 1;
+  int ret = gd_get_frame(gd);
+  gd->loop_count = 1;
+  return ret;
+}
+
+int eye_gif_frames_build(eye_gif_frames_t *frames, lv_obj_t *gif) {
+  lv_gif_t *gifobj = (lv_gif_t *)gif;
+
+  eye_gif_frames_free(frames);
+  if (!gif || !gifobj->gif) return -1;
+
+  const lv_image_dsc_t *dsc = lv_image_get_src(gif);
+  uint32_t best = 0, best_cov = 0, cnt = 0;
+  if (!dsc || dsc->header.cf != LV_COLOR_FORMAT_ARGB8888) return -1;
+  frames->data_size = dsc->data_size;
+  uint32_t px_cnt = frames->data_size / 4;
+
+  uint8_t *scratch = lv_malloc(frames->data_size);
+  if (!scratch) return -1;
+  int32_t loop_count = gifobj->gif->loop_count;
+
+  // 第一遍：找出覆盖面积最大的一帧，最多看 EYE_GIF_SCAN_MAX 帧
+  gd_rewind(gifobj->gif);
+  while (cnt < EYE_GIF_SCAN_MAX && _get_frame_once(gifobj->gif) > 0) {
+    gd_render_frame(gifobj->gif, scratch);
+    uint32_t cov = _coverage(scratch, frames->data_size);
+    if (cov > best_cov) {
+      best_cov = cov;
+      best = cnt;
+    }
+    cnt++;
+  }
+
+  // 第二遍：在第一帧和这一帧之间均匀取帧
+  uint32_t keep = best + 1 < EYE_GIF_MAX_FRAMES ? best + 1 : EYE_GIF_MAX_FRAMES;
+  uint32_t next = 0;  // 下一个要保留的帧在原 GIF 中的序号
+  gd_rewind(gifobj->gif);
+  for (uint32_t i = 0; cnt > 0 && i <= best && frames->frame_cnt < keep; i++) {
+    if (_get_frame_once(gifobj->gif) <= 0) break;
+    if (i != next) continue;
+
+    uint8_t *buf = lv_malloc(px_cnt * 3);
+    if (!buf) break;
+    gd_render_frame(gifobj->gif, scratch);
+    _pack_frame(buf, scratch, px_cnt);
+    frames->frames[frames->frame_cnt++] = buf;
+    if (keep > 1) next = (frames->frame_cnt * best + (keep - 1) / 2) / (keep - 1);
+  }
+  lv_free(scratch);
+
+  // 下次播放从第一帧开始，循环次数交还给播放器
+  gd_rewind(gifobj->gif);
+  gifobj->gif->loop_count = loop_count;
+
+  frames->shown = UINT32_MAX;
+  return frames->frame_cnt ? 0 : -1;
+}
+
+void eye_gif_frames_show(eye_gif_frames_t *frames, lv_obj_t *gif,
+                         uint32_t idx) {
+  if (frames->frame_cnt == 0) return;
+  if (idx >= frames->frame_cnt) idx = frames->frame_cnt - 1;
+  if (idx == frames->shown) return;
+
+  const lv_image_dsc_t *dsc = lv_image_get_src(gif);
+  if (dsc->data_size != frames->data_size) return;  // 素材已经换了
+  _unpack_frame((uint8_t *)dsc->data, frames->frames[idx],
+                frames->data_size / 4);
+  lv_image_cache_drop(dsc);
+  lv_obj_invalidate(gif);
+  frames->shown = idx;
+}
+
+void eye_gif_frames_free(eye_gif_frames_t *frames) {
+  for (uint32_t i = 0; i < frames->frame_cnt; i++) lv_free(frames->frames[i]);
+  memset(frames, 0, sizeof(*frames));
+  frames->shown = UINT32_MAX;
+}
+
+void eye_gif_player_get_stats(lv_obj_t *gif, eye_gif_player_stats_t *stats,
+                              bool reset) {
+  gif_player_t *p = _find(gif);
+  if (!p) {
+    memset(stats, 0, sizeof(*stats));
+    return;
+  }
+  *stats = p->stats;
+  if (reset) memset(&p->stats, 0, sizeof(p->stats));
+}
@@ -0,0 +1,114 @@
+#ifndef EYE_GIF_PLAYER_H
+#define EYE_GIF_PLAYER_H
+
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 按共享动画时钟播放 GIF
+ *
+ * lv_gif 的帧定时器每次触发只前进一帧，并把下一帧的计时从“现在”算起，
+ * 负载高时定时器迟到，动画就整体变慢；左右眼各自计时，也会慢慢错开。
+ *
+ * 接管后 GIF 不再自己计时：挂在同一个动画时钟上的图层由时钟的定时器在
+ * 同一时刻采样，按时钟读数（从播放起点累加帧延时）选出应显示的帧。
+ * 迟到时只解码、不渲染中间帧，直接追到当前时刻；左右眼读同一个时钟，
+ * 始终显示同一帧，不需要在循环结束时互相 restart。
+ *
+ * 时钟的定时器比预期晚触发超过 EYE_GIF_MAX_LAG_MS（严重卡顿）时，
+ * 时钟在卡顿期间视为停走，不再追赶。定时器周期设为到最近一帧的剩余时间。
+ */
+
+#define EYE_GIF_MAX_PLAYERS 8
+#define EYE_GIF_MAX_FRAMES 16   // 帧表最多缓存的帧数
+#define EYE_GIF_SCAN_MAX 512    // 建表时最多解码的帧数
+#define EYE_GIF_MAX_LAG_MS 250  // 超过该延迟不再追赶，时钟顺延
+
+typedef enum {
+  EYE_GIF_CATCHUP_SKIP,  // 落后时跳帧，保持实际播放速度
+  EYE_GIF_CATCHUP_NONE,  // 每次只前进一帧，落后时时钟整体变慢
+} eye_gif_catchup_t;
+
+typedef struct eye_anim_clock_t eye_anim_clock_t;
+
+/* 挂在时钟上的所有图层都播放结束（循环次数用完）时调用一次，没有图层时也算结束 */
+typedef void (*eye_anim_clock_cb_t)(eye_anim_clock_t *clock, void *user_data);
+
+struct eye_anim_clock_t {
+  lv_timer_t *timer;
+  eye_gif_catchup_t catchup;
+  uint64_t origin_us;    // 时钟读数 0 对应的单调时间
+  uint64_t paused_us;    // 暂停时的时钟读数
+  uint64_t wake_us;      // 预期的下次定时器触发时刻
+  uint32_t generation;   // 每次 restart 加一，图层据此回到第一帧
+  bool paused;
+  eye_anim_clock_cb_t finished_cb;
+  void *user_data;
+};
+
+/*
+ * 帧表：按序号直接显示 GIF 的某一帧
+ *
+ * GIF 只能从头顺序解码。建表时先完整解码一遍，找出画面覆盖面积最大的一帧
+ * （眼皮 GIF 中眼睛闭得最紧的一帧），再解码到这一帧，在第一帧和它之间均匀取
+ * 最多 EYE_GIF_MAX_FRAMES 帧缓存下来，之后显示任意一帧不必再解码。
+ * 每帧按 RGB565A8 存放（240x240 约 170 KB），显示时展开到 ARGB8888 画布；
+ * 建表时另需一个画布大小的临时缓冲。循环 GIF 建表时也只解码一轮。
+ */
+typedef struct {
+  uint8_t *frames[EYE_GIF_MAX_FRAMES];
+  uint32_t frame_cnt;    // 缓存的帧数，0 表示未建表
+  uint32_t data_size;    // 画布字节数（ARGB8888）
+  uint32_t shown;        // 当前显示的帧，UINT32_MAX 表示不是帧表中的帧
+} eye_gif_frames_t;
+
+typedef struct {
+  uint32_t shown_cnt;    // 渲染显示的帧数
+  uint32_t dropped_cnt;  // 为追赶时间只解码未显示的帧数
+} eye_gif_player_stats_t;
+
+/* 初始化时钟（暂停状态） */
+void eye_anim_clock_init(eye_anim_clock_t *clock, eye_gif_catchup_t catchup);
+void eye_anim_clock_deinit(eye_anim_clock_t *clock);
+
+void eye_anim_clock_set_finished_cb(eye_anim_clock_t *clock,
+                                    eye_anim_clock_cb_t cb, void *user_data);
+
+/* 从 0 开始走，所有图层立即回到第一帧 */
+void eye_anim_clock_restart(eye_anim_clock_t *clock);
+void eye_anim_clock_pause(eye_anim_clock_t *clock);
+void eye_anim_clock_resume(eye_anim_clock_t *clock);
+
+/* 当前时钟读数（微秒） */
+uint64_t eye_anim_clock_get_us(const eye_anim_clock_t *clock);
+
+/* 把 GIF 挂到时钟上（需已 lv_gif_set_src；换源或换时钟时重新调用） */
+void eye_gif_player_attach(lv_obj_t *gif, eye_anim_clock_t *clock);
+
+/*
+ * 设置循环次数（含义同 lv_gif_set_loop_count），需先 attach
+ * gd_rewind 会重置循环次数，时钟每次 restart 回到第一帧后重新设置
+ */
+void eye_gif_player_set_loop_count(lv_obj_t *gif, int32_t count);
+
+/* 解码 gif 建立帧表（已有的表先释放），失败返回 -1；解码器回到第一帧之前 */
+int eye_gif_frames_build(eye_gif_frames_t *frames, lv_obj_t *gif);
+
+/* 显示帧表中的第 idx 帧（超出时显示最后一帧） */
+void eye_gif_frames_show(eye_gif_frames_t *frames, lv_obj_t *gif, uint32_t idx);
+
+/* 释放帧表 */
+void eye_gif_frames_free(eye_gif_frames_t *frames);
+
+/* 读取统计信息 */
+void eye_gif_player_get_stats(lv_obj_t *gif, eye_gif_player_stats_t *stats,
+                              bool reset);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EYE_GIF_PLAYER_H */
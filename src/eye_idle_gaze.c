@@ -0,0 +1,117 @@
+#include "eye_idle_gaze.h"
+
+#include <math.h>
+#include <stddef.h>
+
+#include "eye_rand.h"
+
+#define MICRO_MS_MIN 100  // 两次微扫视的最短间隔
+
+static float _uniform(eye_idle_gaze_t *idle) {
+  return eye_rand_uniform(&idle->rng);
+}
+
+/* 平均值为 mean_ms 的指数分布，截断到 4 倍平均值 */
+static uint64_t _exp_us(eye_idle_gaze_t *idle, uint32_t mean_ms) {
+  float t = eye_rand_exp(&idle->rng, (float)mean_ms);
+  if (t > 4.0f * mean_ms) t = 4.0f * mean_ms;
+  return (uint64_t)(t * 1000.0f);
+}
+
+/* 半径为 r 的圆内均匀分布的一点 */
+static void _disk(eye_idle_gaze_t *idle, float r, float *x, float *y) {
+  float d = r * sqrtf(_uniform(idle));
+  float a = 6.2831853f * _uniform(idle);
+  *x = d * cosf(a);
+  *y = d * sinf(a);
+}
+
+static uint64_t _fixation_us(eye_idle_gaze_t *idle) {
+  const eye_idle_gaze_config_t *cfg = &idle->cfg;
+  uint32_t extra = cfg->fixation_ms_mean > cfg->fixation_ms_min
+                       ? cfg->fixation_ms_mean - cfg->fixation_ms_min
+                       : 0;
+  return cfg->fixation_ms_min * 1000ULL + _exp_us(idle, extra);
+}
+
+static uint64_t _micro_us(eye_idle_gaze_t *idle) {
+  uint32_t mean = idle->cfg.micro_ms_mean;
+  uint32_t extra = mean > MICRO_MS_MIN ? mean - MICRO_MS_MIN : 0;
+  return MICRO_MS_MIN * 1000ULL + _exp_us(idle, extra);
+}
+
+/* 开始在当前注视点上注视 */
+static void _fixate(eye_idle_gaze_t *idle, uint64_t start_us) {
+  idle->saccade_us = start_us + _fixation_us(idle);
+  idle->micro_us = start_us + _micro_us(idle);
+}
+
+void eye_idle_gaze_default_config(eye_idle_gaze_config_t *cfg) {
+  cfg->fixation_ms_min = EYE_IDLE_GAZE_FIXATION_MS_MIN;
+  cfg->fixation_ms_mean = EYE_IDLE_GAZE_FIXATION_MS_MEAN;
+  cfg->saccade_range = EYE_IDLE_GAZE_SACCADE_RANGE;
+  cfg->center_bias = EYE_IDLE_GAZE_CENTER_BIAS;
+  cfg->micro_ms_mean = EYE_IDLE_GAZE_MICRO_MS_MEAN;
+  cfg->micro_amp = EYE_IDLE_GAZE_MICRO_AMP;
+  cfg->resume_ms = EYE_IDLE_GAZE_RESUME_MS;
+  cfg->seed = 0;
+}
+
+void eye_idle_gaze_init(eye_idle_gaze_t *idle, const eye_idle_gaze_config_t *cfg,
+                        uint64_t now_us) {
+  if (cfg) {
+    idle->cfg = *cfg;
+  } else {
+    eye_idle_gaze_default_config(&idle->cfg);
+  }
+
+  eye_rand_seed(&idle->rng, idle->cfg.seed, now_us, 2654435761u);
+
+  idle->cx = idle->cy = 0.0f;
+  idle->hold_until_us = 0;
+  _fixate(idle, now_us);
+}
+
+void eye_idle_gaze_hold(eye_idle_gaze_t *idle, uint64_t now_us, float x,
+                        float y) {
+  idle->cx = x;
+  idle->cy = y;
+  idle->hold_until_us = now_us + idle->cfg.resume_ms * 1000ULL;
+  _fixate(idle, idle->hold_until_us);
+}
+
+eye_idle_gaze_event_t eye_idle_gaze_update(eye_idle_gaze_t *idle,
+                                           uint64_t now_us, float *x,
+                                           float *y) {
+  const eye_idle_gaze_config_t *cfg = &idle->cfg;
+
+  if (now_us < idle->hold_until_us) return EYE_IDLE_GAZE_NONE;
+
+  if (now_us >= idle->saccade_us) {
+    // 扫视：偶尔回到中心附近，其余在整个范围内均匀选点
+    float r = _uniform(idle) < cfg->center_bias ? cfg->saccade_range * 0.25f
+                                                : cfg->saccade_range;
+    _disk(idle, r, &idle->cx, &idle->cy);
+    _fixate(idle, now_us);
+    *x = idle->cx;
+    *y = idle->cy;
+    return EYE_IDLE_GAZE_SACCADE;
+  }
+
+  if (cfg->micro_ms_mean && now_us >= idle->micro_us) {
+    // 微扫视：围绕注视点跳动，不改变注视点
+    float dx, dy;
+    _disk(idle, cfg->micro_amp, &dx, &dy);
+    idle->micro_us = now_us + _micro_us(idle);
+    *x = idle->cx + dx;
+    *y = idle->cy + dy;
+    return EYE_IDLE_GAZE_MICRO;
+  }
+  return EYE_IDLE_GAZE_NONE;
+}
+
+uint64_t eye_idle_gaze_next_us(const eye_idle_gaze_t *idle) {
+  uint64_t next = idle->saccade_us;
+  if (idle->cfg.micro_ms_mean && idle->micro_us < next) next = idle->micro_us;
+  return next > idle->hold_until_us ? next : idle->hold_until_us;
+}
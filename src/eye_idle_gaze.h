@@ -0,0 +1,79 @@
+#ifndef EYE_IDLE_GAZE_H
+#define EYE_IDLE_GAZE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 空闲视线
+ *
+ * 没有外部视线命令时自己产生视线目标：注视一段时间后扫视到新位置，
+ * 注视期间穿插微扫视（在注视点附近的小幅跳动）。注视时长服从最短时长加
+ * 指数分布，扫视目标在圆内均匀分布，并有一定概率回到中心附近。
+ *
+ * 随机数用种子固定的 xorshift，同一种子得到同样的序列；不分配内存。
+ * 坐标为相对 max_offset 的比例（单位圆），由调用方换算成像素。
+ */
+
+#define EYE_IDLE_GAZE_FIXATION_MS_MIN 400    // 注视最短时长
+#define EYE_IDLE_GAZE_FIXATION_MS_MEAN 1500  // 注视平均时长
+#define EYE_IDLE_GAZE_SACCADE_RANGE 0.8f     // 扫视目标所在圆的半径
+#define EYE_IDLE_GAZE_CENTER_BIAS 0.3f       // 扫视回到中心附近的概率
+#define EYE_IDLE_GAZE_MICRO_MS_MEAN 600      // 微扫视平均间隔
+#define EYE_IDLE_GAZE_MICRO_AMP 0.04f        // 微扫视幅度
+#define EYE_IDLE_GAZE_RESUME_MS 3000         // 外部视线命令后多久恢复
+
+typedef struct {
+  uint32_t fixation_ms_min;    // 注视最短时长
+  uint32_t fixation_ms_mean;   // 注视平均时长（不小于最短时长）
+  float saccade_range;         // 扫视目标所在圆的半径（0~1）
+  float center_bias;           // 扫视回到中心附近的概率（0~1）
+  uint32_t micro_ms_mean;      // 微扫视平均间隔，0 关闭微扫视
+  float micro_amp;             // 微扫视幅度（0~1）
+  uint32_t resume_ms;          // 最近一次外部视线命令后多久恢复
+  uint32_t seed;               // 随机数种子，0 表示由当前时刻生成
+} eye_idle_gaze_config_t;
+
+typedef enum {
+  EYE_IDLE_GAZE_NONE = 0,  // 没有新目标
+  EYE_IDLE_GAZE_SACCADE,   // 扫视到新注视点
+  EYE_IDLE_GAZE_MICRO,     // 注视点附近的微扫视
+} eye_idle_gaze_event_t;
+
+typedef struct {
+  eye_idle_gaze_config_t cfg;
+  uint32_t rng;
+  float cx, cy;                // 当前注视点
+  uint64_t saccade_us;         // 下次扫视时刻
+  uint64_t micro_us;           // 下次微扫视时刻
+  uint64_t hold_until_us;      // 让给外部命令，此前不产生目标
+} eye_idle_gaze_t;
+
+/* 填入默认参数 */
+void eye_idle_gaze_default_config(eye_idle_gaze_config_t *cfg);
+
+/* 初始化，cfg 为 NULL 时使用默认参数；从中心开始注视 */
+void eye_idle_gaze_init(eye_idle_gaze_t *idle, const eye_idle_gaze_config_t *cfg,
+                        uint64_t now_us);
+
+/* 收到外部视线命令 (x, y)：暂停 resume_ms，之后以该位置为注视点继续 */
+void eye_idle_gaze_hold(eye_idle_gaze_t *idle, uint64_t now_us, float x,
+                        float y);
+
+/* 推进到 now_us，有新目标时写入 (x, y) 并返回事件类型，否则返回 NONE */
+eye_idle_gaze_event_t eye_idle_gaze_update(eye_idle_gaze_t *idle,
+                                           uint64_t now_us, float *x,
+                                           float *y);
+
+/* 下一次可能产生目标的时刻 */
+uint64_t eye_idle_gaze_next_us(const eye_idle_gaze_t *idle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EYE_IDLE_GAZE_H */
@@ -0,0 +1,126 @@
+#include "eye_layer_cache.h"
+
+#include <string.h>
+
+/* 计算 ARGB8888 帧中 alpha 非零像素的包围盒，全透明返回 false */
+static bool _alpha_bbox(const lv_image_dsc_t *src, lv_area_t *bbox) {
+  int32_t w = src->header.w;
+  int32_t h = src->header.h;
+  uint32_t stride = src->header.stride ? src->header.stride : w * 4;
+
+  bbox->x1 = w;
+  bbox->y1 = h;
+  bbox->x2 = -1;
+  bbox->y2 = -1;
+  for (int32_t y = 0; y < h; y++) {
+    const uint8_t *px = src->data + y * stride;
+    for (int32_t x = 0; x < w; x++) {
+      if (px[x * 4 + 3] == 0) continue;
+      if (x < bbox->x1) bbox->x1 = x;
+      if (x > bbox->x2) bbox->x2 = x;
+      if (y < bbox->y1) bbox->y1 = y;
+      if (y > bbox->y2) bbox->y2 = y;
+    }
+  }
+  return bbox->x2 >= 0;
+}
+
+/* ARGB8888 -> RGB565A8，只转换包围盒内的像素 */
+static bool _build_overlay(eye_layer_cache_t *cache,
+                           const lv_image_dsc_t *src, const lv_area_t *bbox) {
+  int32_t w = lv_area_get_width(bbox);
+  int32_t h = lv_area_get_height(bbox);
+  uint32_t src_stride = src->header.stride ? src->header.stride
+                                           : src->header.w * 4;
+
+  if (cache->overlay && (cache->overlay->header.w != w ||
+                         cache->overlay->header.h != h)) {
+    lv_draw_buf_destroy(cache->overlay);
+    cache->overlay = NULL;
+  }
+  if (!cache->overlay) {
+    cache->overlay = lv_draw_buf_create(w, h, LV_COLOR_FORMAT_RGB565A8, 0);
+    if (!cache->overlay) return false;
+  }
+
+  uint32_t stride = cache->overlay->header.stride;
+  uint8_t *alpha_plane = cache->overlay->data + stride * h;
+  uint32_t alpha_stride = stride / 2;
+
+  for (int32_t y = 0; y < h; y++) {
+    const uint8_t *s = src->data + (bbox->y1 + y) * src_stride + bbox->x1 * 4;
+    uint16_t *rgb = (uint16_t *)(cache->overlay->data + y * stride);
+    uint8_t *a = alpha_plane + y * alpha_stride;
+    for (int32_t x = 0; x < w; x++, s += 4) {
+      /* lv_color32_t 内存顺序为 B G R A */
+      rgb[x] = (uint16_t)(((s[2] & 0xF8) << 8) | ((s[1] & 0xFC) << 3) |
+                          (s[0] >> 3));
+      a[x] = s[3];
+    }
+  }
+  return true;
+}
+
+void eye_layer_cache_init(eye_layer_cache_t *cache, lv_obj_t *scr,
+                          lv_obj_t *eyelid_gif) {
+  memset(cache, 0, sizeof(*cache));
+  cache->eyelid_gif = eyelid_gif;
+  cache->enabled = true;
+
+  cache->overlay_img = lv_image_create(scr);
+  lv_obj_add_flag(cache->overlay_img, LV_OBJ_FLAG_HIDDEN);
+  lv_obj_move_foreground(cache->overlay_img);
+}
+
+void eye_layer_cache_build(eye_layer_cache_t *cache) {
+  if (!cache->enabled || !cache->eyelid_gif) return;
+
+  const lv_image_dsc_t *frame = lv_image_get_src(cache->eyelid_gif);
+  if (!frame || !frame->data ||
+      frame->header.cf != LV_COLOR_FORMAT_ARGB8888) {
+    return;  // 不支持的帧格式，保持原始图层
+  }
+
+  lv_area_t bbox;
+  bool has_overlay = _alpha_bbox(frame, &bbox);
+  if (has_overlay && !_build_overlay(cache, frame, &bbox)) return;
+
+  if (has_overlay) {
+    /* overlay 按包围盒偏移放在眼皮 GIF 原来的位置上；刚创建时坐标还没有布局 */
+    lv_area_t gif_coords;
+    lv_obj_update_layout(cache->eyelid_gif);
+    lv_obj_get_coords(cache->eyelid_gif, &gif_coords);
+    lv_image_cache_drop(cache->overlay);
+    lv_image_set_src(cache->overlay_img, cache->overlay);
+    lv_obj_set_pos(cache->overlay_img, gif_coords.x1 + bbox.x1,
+                   gif_coords.y1 + bbox.y1);
+    lv_obj_remove_flag(cache->overlay_img, LV_OBJ_FLAG_HIDDEN);
+  } else {
+    lv_obj_add_flag(cache->overlay_img, LV_OBJ_FLAG_HIDDEN);
+  }
+
+  lv_obj_add_flag(cache->eyelid_gif, LV_OBJ_FLAG_HIDDEN);
+  cache->valid = true;
+  cache->build_cnt++;
+}
+
+void eye_layer_cache_invalidate(eye_layer_cache_t *cache) {
+  if (!cache->valid) return;
+
+  lv_obj_remove_flag(cache->eyelid_gif, LV_OBJ_FLAG_HIDDEN);
+  lv_obj_add_flag(cache->overlay_img, LV_OBJ_FLAG_HIDDEN);
+  cache->valid = false;
+}
+
+void eye_layer_cache_set_enabled(eye_layer_cache_t *cache, bool en) {
+  cache->enabled = en;
+  if (!en) eye_layer_cache_invalidate(cache);
+}
+
+void eye_layer_cache_deinit(eye_layer_cache_t *cache) {
+  eye_layer_cache_invalidate(cache);
+
+  if (cache->overlay_img) lv_obj_del(cache->overlay_img);
+  if (cache->overlay) lv_draw_buf_destroy(cache->overlay);
+  memset(cache, 0, sizeof(*cache));
+}
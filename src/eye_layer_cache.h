@@ -0,0 +1,47 @@
+#ifndef EYE_LAYER_CACHE_H
+#define EYE_LAYER_CACHE_H
+
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 静态图层缓存
+ *
+ * 眼睛静止（眼皮 GIF 暂停）时，眼皮每帧输出的像素完全相同。缓存把当前帧
+ * 转换为 RGB565A8 的 overlay，裁剪到不透明区域的包围盒，代替全屏 ARGB8888 的
+ * 眼皮 GIF 参与混合；眼底仍是纯色填充，不需要缓存。
+ * 眼皮开始播放或素材切换时失效，眼皮重新静止后重建。
+ */
+typedef struct {
+  lv_obj_t *eyelid_gif;      // 原始眼皮 GIF（缓存有效时隐藏）
+  lv_obj_t *overlay_img;     // 显示 overlay 的图像对象（最顶层）
+  lv_draw_buf_t *overlay;    // RGB565A8 眼皮图
+  bool enabled;              // 是否启用缓存
+  bool valid;                // 当前缓存是否正在使用
+  uint32_t build_cnt;        // 重建次数（统计）
+} eye_layer_cache_t;
+
+/* 初始化缓存（不立即构建） */
+void eye_layer_cache_init(eye_layer_cache_t *cache, lv_obj_t *scr,
+                          lv_obj_t *eyelid_gif);
+
+/* 用眼皮当前帧（须为 ARGB8888，否则保持原始图层）构建缓存并切换到缓存图层 */
+void eye_layer_cache_build(eye_layer_cache_t *cache);
+
+/* 失效：恢复原始图层（眼皮即将播放、素材切换） */
+void eye_layer_cache_invalidate(eye_layer_cache_t *cache);
+
+/* 启用/禁用缓存（禁用时立即失效） */
+void eye_layer_cache_set_enabled(eye_layer_cache_t *cache, bool en);
+
+/* 释放缓存占用的内存和对象 */
+void eye_layer_cache_deinit(eye_layer_cache_t *cache);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EYE_LAYER_CACHE_H */
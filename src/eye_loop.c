@@ -0,0 +1,142 @@
+#include "eye_loop.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include "lvgl.h"
+
+typedef struct {
+  int fd;
+  eye_loop_fd_cb_t cb;
+  void *user_data;
+} loop_fd_t;
+
+#define EYE_LOOP_FALLBACK_MS 5  // 事件循环不可用时的最长轮询间隔
+
+static int g_epoll_fd = -1;
+static int g_timer_fd = -1;
+static int g_event_fd = -1;
+static loop_fd_t g_fds[EYE_LOOP_MAX_FDS];
+static uint32_t g_fd_cnt;
+static eye_loop_stats_t g_stats;
+
+static int loop_watch(int fd, uint32_t events) {
+  struct epoll_event ev = {.events = events, .data.fd = fd};
+  return epoll_ctl(g_epoll_fd, EPOLL_CTL_ADD, fd, &ev);
+}
+
+static void loop_drain(int fd) {
+  uint64_t val;
+  while (read(fd, &val, sizeof(val)) == sizeof(val)) {
+  }
+}
+
+int eye_loop_init(void) {
+  g_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  g_timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  g_event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (g_epoll_fd < 0 || g_timer_fd < 0 || g_event_fd < 0 ||
+      loop_watch(g_timer_fd, EPOLLIN) < 0 ||
+      loop_watch(g_event_fd, EPOLLIN) < 0) {
+    printf("eye: event loop init failed: %s\n", strerror(errno));
+    eye_loop_deinit();
+    return -1;
+  }
+
+  g_fd_cnt = 0;
+  memset(&g_stats, 0, sizeof(g_stats));
+  return 0;
+}
+
+void eye_loop_deinit(void) {
+  if (g_event_fd >= 0) close(g_event_fd);
+  if (g_timer_fd >= 0) close(g_timer_fd);
+  if (g_epoll_fd >= 0) close(g_epoll_fd);
+  g_event_fd = g_timer_fd = g_epoll_fd = -1;
+  g_fd_cnt = 0;
+}
+
+int eye_loop_add_fd(int fd, uint32_t events, eye_loop_fd_cb_t cb,
+                    void *user_data) {
+  if (g_epoll_fd < 0 || g_fd_cnt == EYE_LOOP_MAX_FDS) return -1;
+  if (loop_watch(fd, events) < 0) return -1;
+
+  g_fds[g_fd_cnt].fd = fd;
+  g_fds[g_fd_cnt].cb = cb;
+  g_fds[g_fd_cnt].user_data = user_data;
+  g_fd_cnt++;
+  return 0;
+}
+
+void eye_loop_remove_fd(int fd) {
+  for (uint32_t i = 0; i < g_fd_cnt; i++) {
+    if (g_fds[i].fd != fd) continue;
+    epoll_ctl(g_epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+    g_fds[i] = g_fds[--g_fd_cnt];
+    return;
+  }
+}
+
+void eye_loop_wait(uint32_t timeout_ms) {
+  eye_loop_wait_us(timeout_ms == LV_NO_TIMER_READY ? UINT64_MAX
+                                                   : (uint64_t)timeout_ms * 1000);
+}
+
+void eye_loop_wait_us(uint64_t timeout_us) {
+  struct epoll_event events[EYE_LOOP_MAX_FDS + 2];
+
+  if (timeout_us == 0) return;
+
+  // 事件循环不可用时退回固定上限的轮询
+  if (g_epoll_fd < 0) {
+    uint64_t max_us = EYE_LOOP_FALLBACK_MS * 1000;
+    usleep((useconds_t)(timeout_us < max_us ? timeout_us : max_us));
+    return;
+  }
+
+  // 用 timerfd 定时，epoll_wait 本身无限等待；UINT64_MAX 时不设定时器
+  struct itimerspec its = {0};
+  if (timeout_us != UINT64_MAX) {
+    its.it_value.tv_sec = (time_t)(timeout_us / 1000000);
+    its.it_value.tv_nsec = (long)(timeout_us % 1000000) * 1000L;
+  }
+  timerfd_settime(g_timer_fd, 0, &its, NULL);
+
+  g_stats.wait_cnt++;
+  int n = epoll_wait(g_epoll_fd, events, EYE_LOOP_MAX_FDS + 2, -1);
+  for (int i = 0; i < n; i++) {
+    int fd = events[i].data.fd;
+    if (fd == g_timer_fd) {
+      loop_drain(fd);
+      g_stats.timer_wakeups++;
+    } else if (fd == g_event_fd) {
+      loop_drain(fd);
+      g_stats.event_wakeups++;
+    } else {
+      for (uint32_t j = 0; j < g_fd_cnt; j++) {
+        if (g_fds[j].fd != fd) continue;
+        g_stats.fd_wakeups++;
+        g_fds[j].cb(fd, events[i].events, g_fds[j].user_data);
+        break;
+      }
+    }
+  }
+}
+
+void eye_loop_wake(void) {
+  uint64_t one = 1;
+  if (g_event_fd >= 0) {
+    ssize_t ret = write(g_event_fd, &one, sizeof(one));
+    (void)ret;
+  }
+}
+
+void eye_loop_get_stats(eye_loop_stats_t *stats, bool reset) {
+  *stats = g_stats;
+  if (reset) memset(&g_stats, 0, sizeof(g_stats));
+}
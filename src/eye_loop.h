@@ -0,0 +1,56 @@
+#ifndef EYE_LOOP_H
+#define EYE_LOOP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 事件驱动主循环
+ *
+ * 用 epoll 同时等待：
+ *  - timerfd：精确睡到下一个 LVGL 定时器到期（lv_timer_handler 的返回值）
+ *  - eventfd：其它线程投递命令后立即唤醒
+ *  - 额外注册的 fd（由回调处理）
+ */
+
+#define EYE_LOOP_MAX_FDS 8
+
+typedef void (*eye_loop_fd_cb_t)(int fd, uint32_t events, void *user_data);
+
+typedef struct {
+  uint32_t wait_cnt;      // 等待次数
+  uint32_t timer_wakeups; // 定时器到期唤醒次数
+  uint32_t event_wakeups; // 命令唤醒次数
+  uint32_t fd_wakeups;    // 其它 fd 唤醒次数
+} eye_loop_stats_t;
+
+/* 创建 epoll/timerfd/eventfd，成功返回 0 */
+int eye_loop_init(void);
+void eye_loop_deinit(void);
+
+/* 注册额外的 fd（EPOLLIN 等事件），成功返回 0 */
+int eye_loop_add_fd(int fd, uint32_t events, eye_loop_fd_cb_t cb,
+                    void *user_data);
+void eye_loop_remove_fd(int fd);
+
+/* 睡眠直到超时、被唤醒或有 fd 事件；timeout_ms 为 LV_NO_TIMER_READY 时一直等待 */
+void eye_loop_wait(uint32_t timeout_ms);
+
+/* 同上，微秒精度；timeout_us 为 UINT64_MAX 时一直等待 */
+void eye_loop_wait_us(uint64_t timeout_us);
+
+/* 唤醒主循环（线程安全，可在任意线程调用） */
+void eye_loop_wake(void);
+
+/* 读取统计信息 */
+void eye_loop_get_stats(eye_loop_stats_t *stats, bool reset);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EYE_LOOP_H */
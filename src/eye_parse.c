@@ -0,0 +1,30 @@
+#include "eye_parse.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+bool eye_parse_int(const char *tok, int32_t *val) {
+  char *end;
+  if (!tok) return false;
+  long v = strtol(tok, &end, 0);
+  if (*end != '\0') return false;
+  *val = (int32_t)v;
+  return true;
+}
+
+bool eye_parse_eye(const char *tok, uint32_t cnt, uint8_t all, uint8_t *eye) {
+  int32_t idx;
+  if (!tok) return false;
+  if (strcmp(tok, "all") == 0) {
+    *eye = all;
+  } else if (strcmp(tok, "left") == 0) {
+    *eye = 0;
+  } else if (strcmp(tok, "right") == 0) {
+    *eye = 1;
+  } else if (eye_parse_int(tok, &idx) && idx >= 0 && (uint32_t)idx < cnt) {
+    *eye = (uint8_t)idx;
+  } else {
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,28 @@
+#ifndef EYE_PARSE_H
+#define EYE_PARSE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 文本命令的词法解析
+ *
+ * 控制协议的文本模式和时间线文件共用，参数均为 strtok_r 切出的单词，
+ * 为 NULL（参数缺失）时返回 false。
+ */
+
+/* 整个单词是一个整数（十进制，或 0x 开头的十六进制） */
+bool eye_parse_int(const char *tok, int32_t *val);
+
+/* 眼睛：all 写入 all，left、right 为 0、1，数字为小于 cnt 的序号 */
+bool eye_parse_eye(const char *tok, uint32_t cnt, uint8_t all, uint8_t *eye);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EYE_PARSE_H */
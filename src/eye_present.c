@@ -0,0 +1,108 @@
+#include "eye_present.h"
+
+#include <string.h>
+
+#include "eye_tick.h"
+#include "lib/drm_display.h"
+#include "lib/fbdev_display.h"
+
+static lv_display_t *g_disps[EYE_PRESENT_MAX_DISPLAYS];
+static uint32_t g_disp_cnt;
+static lv_display_t *g_drm_disps[EYE_PRESENT_MAX_DISPLAYS];
+static uint32_t g_drm_disp_cnt;
+static eye_present_stats_t g_stats;
+
+void eye_present_init(lv_display_t *const *disps, uint32_t cnt) {
+  if (cnt > EYE_PRESENT_MAX_DISPLAYS) cnt = EYE_PRESENT_MAX_DISPLAYS;
+
+  g_disp_cnt = cnt;
+  for (uint32_t i = 0; i < cnt; i++) {
+    g_disps[i] = disps[i];
+    fbdev_display_set_deferred_present(disps[i], true);
+  }
+  memset(&g_stats, 0, sizeof(g_stats));
+}
+
+void eye_present_init_drm(lv_display_t *const *disps, uint32_t cnt) {
+#if LV_USE_LINUX_DRM
+  if (cnt > EYE_PRESENT_MAX_DISPLAYS) cnt = EYE_PRESENT_MAX_DISPLAYS;
+
+  g_drm_disp_cnt = cnt;
+  for (uint32_t i = 0; i < cnt; i++) {
+    g_drm_disps[i] = disps[i];
+    drm_display_set_deferred_present(disps[i], true);
+  }
+#else
+  (void)disps;
+  (void)cnt;
+#endif
+}
+
+/* DRM：补齐落后的显示器后，一次原子提交所有新帧 */
+static void _commit_drm(void) {
+#if LV_USE_LINUX_DRM
+  uint32_t pending = 0;
+
+  for (uint32_t i = 0; i < g_drm_disp_cnt; i++) {
+    if (drm_display_is_present_pending(g_drm_disps[i])) pending++;
+  }
+  if (pending == 0) return;
+
+  if (pending < g_drm_disp_cnt) {
+    for (uint32_t i = 0; i < g_drm_disp_cnt; i++) {
+      if (drm_display_is_present_pending(g_drm_disps[i])) continue;
+      lv_refr_now(g_drm_disps[i]);
+      if (drm_display_is_present_pending(g_drm_disps[i])) g_stats.forced_cnt++;
+    }
+  }
+
+  uint32_t presented = drm_display_commit(g_drm_disps, g_drm_disp_cnt);
+  g_stats.commit_cnt++;
+  if (presented > 1) g_stats.stereo_cnt++;  // 同一次提交，翻页时间差为 0
+#endif
+}
+
+void eye_present_commit(void) {
+  uint32_t pending = 0;
+
+  _commit_drm();
+
+  for (uint32_t i = 0; i < g_disp_cnt; i++) {
+    if (fbdev_display_is_present_pending(g_disps[i])) pending++;
+  }
+  if (pending == 0) return;
+
+  // 只有一只眼出了新帧：另一只眼若有待刷新区域，立即渲染，保证同帧提交
+  if (pending < g_disp_cnt) {
+    for (uint32_t i = 0; i < g_disp_cnt; i++) {
+      if (fbdev_display_is_present_pending(g_disps[i])) continue;
+      lv_refr_now(g_disps[i]);
+      if (fbdev_display_is_present_pending(g_disps[i])) g_stats.forced_cnt++;
+    }
+  }
+
+  // 在 vblank 开始时连续翻页，让双眼落在同一个刷新窗口
+  if (fbdev_display_wait_vsync(g_disps[0])) g_stats.vsync_cnt++;
+
+  uint64_t first_us = 0;
+  uint64_t last_us = 0;
+  uint32_t presented = 0;
+  for (uint32_t i = 0; i < g_disp_cnt; i++) {
+    if (!fbdev_display_present(g_disps[i])) continue;
+    last_us = eye_tick_us();
+    if (presented++ == 0) first_us = last_us;
+  }
+
+  g_stats.commit_cnt++;
+  if (presented > 1) {
+    uint32_t skew = (uint32_t)(last_us - first_us);
+    g_stats.stereo_cnt++;
+    g_stats.skew_us_sum += skew;
+    if (skew > g_stats.skew_us_max) g_stats.skew_us_max = skew;
+  }
+}
+
+void eye_present_get_stats(eye_present_stats_t *stats, bool reset) {
+  *stats = g_stats;
+  if (reset) memset(&g_stats, 0, sizeof(g_stats));
+}
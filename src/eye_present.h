@@ -0,0 +1,47 @@
+#ifndef EYE_PRESENT_H
+#define EYE_PRESENT_H
+
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define EYE_PRESENT_MAX_DISPLAYS 4  // 与 EYE_MAX_CNT 一致
+
+/*
+ * 立体同步显示调度
+ *
+ * 各显示器渲染完一帧后不再立即翻页，而是在 lv_timer_handler() 返回后统一提交：
+ * 只要有一只眼有新帧，就先把另一只眼待刷新的区域也立即渲染出来，
+ * 然后等待 vsync（驱动支持 FBIO_WAITFORVSYNC 时），在同一个刷新窗口内连续翻页。
+ */
+typedef struct {
+  uint32_t commit_cnt;    // 提交次数
+  uint32_t stereo_cnt;    // 双眼同时翻页的次数
+  uint32_t forced_cnt;    // 为对齐另一只眼而强制渲染的次数
+  uint32_t vsync_cnt;     // 成功等待 vsync 的次数
+  uint64_t skew_us_sum;   // 左右眼翻页时间差累计
+  uint32_t skew_us_max;   // 左右眼翻页时间差最大值
+} eye_present_stats_t;
+
+/* 注册参与同步提交的 fbdev 显示器（开启延迟翻页） */
+void eye_present_init(lv_display_t *const *disps, uint32_t cnt);
+
+/*
+ * 注册参与同步提交的 DRM 显示器（开启延迟提交）
+ * 同一张卡上的新帧合并成一次原子提交，由内核在 vblank 翻页，不需要等待 vsync
+ */
+void eye_present_init_drm(lv_display_t *const *disps, uint32_t cnt);
+
+/* 在 lv_timer_handler() 之后调用：等待 vsync 并同时提交所有显示器的新帧 */
+void eye_present_commit(void);
+
+/* 读取统计信息 */
+void eye_present_get_stats(eye_present_stats_t *stats, bool reset);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EYE_PRESENT_H */
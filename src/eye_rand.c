@@ -0,0 +1,26 @@
+#include "eye_rand.h"
+
+#include <math.h>
+
+void eye_rand_seed(uint32_t *state, uint32_t seed, uint64_t now_us,
+                   uint32_t mix) {
+  if (seed == 0) seed = (uint32_t)(now_us ^ (now_us >> 32)) * mix;
+  *state = seed ? seed : 1;  // xorshift 的状态不能为 0
+}
+
+uint32_t eye_rand_next(uint32_t *state) {
+  uint32_t x = *state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *state = x;
+  return x;
+}
+
+float eye_rand_uniform(uint32_t *state) {
+  return (eye_rand_next(state) >> 8) * (1.0f / 16777216.0f);
+}
+
+float eye_rand_exp(uint32_t *state, float mean) {
+  return -logf(1.0f - eye_rand_uniform(state)) * mean;
+}
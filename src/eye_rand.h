@@ -0,0 +1,34 @@
+#ifndef EYE_RAND_H
+#define EYE_RAND_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 随机数
+ *
+ * 32 位 xorshift，状态由调用方保存（一个 uint32_t），同一种子得到同样的序列。
+ * 眨眼调度和空闲视线各用各的状态，互不影响。
+ */
+
+/* 设置种子；seed 为 0 时由 now_us 乘以 mix 生成（各模块用不同的 mix 错开） */
+void eye_rand_seed(uint32_t *state, uint32_t seed, uint64_t now_us,
+                   uint32_t mix);
+
+/* 下一个 32 位随机数 */
+uint32_t eye_rand_next(uint32_t *state);
+
+/* [0, 1) 均匀分布 */
+float eye_rand_uniform(uint32_t *state);
+
+/* 平均值为 mean 的指数分布（不截断） */
+float eye_rand_exp(uint32_t *state, float mean);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EYE_RAND_H */
@@ -0,0 +1,45 @@
+#include "eye_tick.h"
+
+#include <stdbool.h>
+#include <time.h>
+
+#define EYE_TICK_CLOCK CLOCK_MONOTONIC
+
+static bool g_inited;
+static time_t g_start_sec;
+
+void eye_tick_init(void) {
+  if (g_inited) return;
+
+  struct timespec ts;
+  clock_gettime(EYE_TICK_CLOCK, &ts);
+  g_start_sec = ts.tv_sec;
+  g_inited = true;
+}
+
+uint32_t eye_tick_ms(void) {
+  struct timespec ts;
+
+  if (!g_inited) eye_tick_init();
+  clock_gettime(EYE_TICK_CLOCK, &ts);  // vDSO，不陷入内核
+
+  // 不缓存秒数：绘制线程也会读 tick，两个静态量分两步更新会读到不一致的组合。
+  // nsec / 1000000 的乘法移位形式，对 0..999999999 精确
+  return (uint32_t)(ts.tv_sec - g_start_sec) * 1000u +
+         (uint32_t)(((uint64_t)ts.tv_nsec * 1125899907ull) >> 50);
+}
+
+uint64_t eye_tick_us(void) {
+  struct timespec ts;
+
+  if (!g_inited) eye_tick_init();
+  clock_gettime(EYE_TICK_CLOCK, &ts);
+  return (uint64_t)(ts.tv_sec - g_start_sec) * 1000000u +
+         (uint64_t)ts.tv_nsec / 1000u;
+}
+
+uint64_t eye_tick_from_monotonic_us(uint64_t mono_us) {
+  if (!g_inited) eye_tick_init();
+  uint64_t start_us = (uint64_t)g_start_sec * 1000000u;
+  return mono_us > start_us ? mono_us - start_us : 0;
+}
@@ -0,0 +1,33 @@
+#ifndef EYE_TICK_H
+#define EYE_TICK_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 单调时钟
+ *
+ * 基于 CLOCK_MONOTONIC，不受 NTP/RTC 调整墙上时间的影响，
+ * 与 timerfd、FBIO_WAITFORVSYNC 等内核时间戳使用同一时钟。
+ */
+
+/* 以当前时刻为起点（可重复调用，只在第一次生效） */
+void eye_tick_init(void);
+
+/* LVGL tick 回调：毫秒，32 位回绕（线程安全，绘制线程也会调用） */
+uint32_t eye_tick_ms(void);
+
+/* 微秒时间戳，用于帧调度和统计 */
+uint64_t eye_tick_us(void);
+
+/* 把 CLOCK_MONOTONIC 的绝对微秒时间戳（如 DRM 翻页事件）换算为 eye_tick_us 的时间 */
+uint64_t eye_tick_from_monotonic_us(uint64_t mono_us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EYE_TICK_H */
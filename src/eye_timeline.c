@@ -0,0 +1,450 @@
+#include "eye_timeline.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "eye_parse.h"
+#include "lvgl.h"
+
+#define LINE_MAX_LEN 256        // 一行的最大长度
+#define NAMES_MAX 2048          // 一条时间线中表情名的总字节数
+
+/* ==================== 解析 ==================== */
+
+static bool _parse_eye(const char *tok, uint8_t *eye) {
+  return eye_parse_eye(tok, EYE_TIMELINE_EYES, EYE_TIMELINE_EYE_ALL, eye);
+}
+
+static bool _parse_ease(const char *tok, uint8_t *ease) {
+  static const char *const names[] = {"step", "linear", "in", "out", "in_out"};
+  for (uint32_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+    if (strcmp(tok, names[i]) == 0) {
+      *ease = (uint8_t)i;
+      return true;
+    }
+  }
+  return false;
+}
+
+/* 解析一个关键帧（时刻之后的部分），返回 NULL 表示成功，否则为错误原因 */
+static const char *_parse_key(char **save, eye_timeline_key_t *key,
+                              const char **name) {
+  char *op = strtok_r(NULL, " \t", save);
+  char *a = strtok_r(NULL, " \t", save);
+  char *b = strtok_r(NULL, " \t", save);
+  char *c = strtok_r(NULL, " \t", save);
+  char *d = strtok_r(NULL, " \t", save);
+  char *e = strtok_r(NULL, " \t", save);
+  int32_t dur;
+
+  *name = NULL;
+  if (!op) return "missing command";
+
+  if (strcmp(op, "gaze") == 0) {
+    key->op = EYE_TIMELINE_OP_GAZE;
+    if (!_parse_eye(a, &key->eye) || !eye_parse_int(b, &key->arg[0]) ||
+        !eye_parse_int(c, &key->arg[1])) {
+      return "usage: <ms> gaze <eye|all> <x> <y> [<ease> <ms>]";
+    }
+    if (d) {
+      if (!_parse_ease(d, &key->ease)) return "unknown easing";
+      if (!eye_parse_int(e, &dur) || dur < 0 || dur > UINT16_MAX) {
+        return "bad easing duration";
+      }
+      key->dur_ms = (uint16_t)dur;
+    }
+  } else if (strcmp(op, "point") == 0) {
+    key->op = EYE_TIMELINE_OP_POINT;
+    if (!eye_parse_int(a, &key->arg[0]) || !eye_parse_int(b, &key->arg[1]) ||
+        !eye_parse_int(c, &key->arg[2])) {
+      return "usage: <ms> point <x> <y> <z>";
+    }
+  } else if (strcmp(op, "blink_once") == 0) {
+    key->op = EYE_TIMELINE_OP_BLINK_ONCE;
+  } else if (strcmp(op, "blink") == 0) {
+    key->op = EYE_TIMELINE_OP_BLINK;
+    if (!eye_parse_int(a, &key->arg[0]) || !eye_parse_int(b, &key->arg[1])) {
+      return "usage: <ms> blink <interval_ms> <count>";
+    }
+  } else if (strcmp(op, "emotion") == 0) {
+    key->op = EYE_TIMELINE_OP_EMOTION;
+    if (!a || strlen(a) > EYE_TIMELINE_NAME_MAX) return "usage: <ms> emotion <name>";
+    *name = a;
+  } else if (strcmp(op, "lid") == 0) {
+    key->op = EYE_TIMELINE_OP_LID;
+    if (!_parse_eye(a, &key->eye) || !eye_parse_int(b, &key->arg[0]) ||
+        key->arg[0] < 0 || key->arg[0] > 100 ||
+        (c && (!eye_parse_int(c, &key->arg[1]) || key->arg[1] < 0))) {
+      return "usage: <ms> lid <eye|all> <pct> [<ms>]";
+    }
+  } else {
+    return "unknown command";
+  }
+  return NULL;
+}
+
+/* 解析用的临时空间（约 8 KB），放在堆上，不占渲染线程的栈 */
+typedef struct {
+  eye_timeline_key_t keys[EYE_TIMELINE_MAX_KEYS];
+  char names[NAMES_MAX];
+  char line[LINE_MAX_LEN];
+} parse_scratch_t;
+
+static eye_timeline_t *_parse(const char *text, parse_scratch_t *sc,
+                              const char **err, uint32_t *err_line) {
+  eye_timeline_key_t *keys = sc->keys;
+  char *names = sc->names;
+  char *line = sc->line;
+  uint32_t key_cnt = 0, names_len = 0, line_no = 0;
+  uint32_t length_ms = 0, end_ms = 0;
+  bool loop = false;
+
+  *err = NULL;
+  while (*text) {
+    size_t len = strcspn(text, "\n");
+    line_no++;
+    *err_line = line_no;
+    if (len >= sizeof(sc->line)) {
+      *err = "line too long";
+      return NULL;
+    }
+    memcpy(line, text, len);
+    line[len] = '\0';
+    text += len + (text[len] == '\n');
+
+    char *comment = strchr(line, '#');
+    if (comment) *comment = '\0';
+
+    char *save;
+    char *first = strtok_r(line, " \t\r", &save);
+    if (!first) continue;  // 空行
+
+    if (strcmp(first, "loop") == 0) {
+      loop = true;
+      continue;
+    }
+    if (strcmp(first, "length") == 0) {
+      int32_t v;
+      if (!eye_parse_int(strtok_r(NULL, " \t\r", &save), &v) || v <= 0) {
+        *err = "usage: length <ms>";
+        return NULL;
+      }
+      length_ms = (uint32_t)v;
+      continue;
+    }
+
+    int32_t t;
+    if (!eye_parse_int(first, &t) || t < 0) {
+      *err = "keyframe must start with a time in ms";
+      return NULL;
+    }
+    if (key_cnt && (uint32_t)t < keys[key_cnt - 1].t_ms) {
+      *err = "keyframe times must not decrease";
+      return NULL;
+    }
+    if (key_cnt == EYE_TIMELINE_MAX_KEYS) {
+      *err = "too many keyframes";
+      return NULL;
+    }
+
+    eye_timeline_key_t *key = &keys[key_cnt];
+    const char *name;
+    memset(key, 0, sizeof(*key));
+    key->t_ms = (uint32_t)t;
+    key->eye = EYE_TIMELINE_EYE_ALL;
+    *err = _parse_key(&save, key, &name);
+    if (*err) return NULL;
+
+    if (name) {
+      size_t n = strlen(name) + 1;
+      if (names_len + n > sizeof(sc->names)) {
+        *err = "too many emotion names";
+        return NULL;
+      }
+      key->name_off = (uint16_t)names_len;
+      memcpy(names + names_len, name, n);
+      names_len += (uint32_t)n;
+    }
+    if (key->t_ms + key->dur_ms > end_ms) end_ms = key->t_ms + key->dur_ms;
+    key_cnt++;
+  }
+
+  *err_line = 0;
+  if (length_ms && key_cnt && keys[key_cnt - 1].t_ms >= length_ms) {
+    *err = "keyframe after length";
+    return NULL;
+  }
+
+  // 时间线、关键帧和表情名放在同一块内存里
+  size_t keys_size = key_cnt * sizeof(eye_timeline_key_t);
+  eye_timeline_t *tl = lv_malloc(sizeof(*tl) + keys_size + names_len);
+  if (!tl) {
+    *err = "out of memory";
+    return NULL;
+  }
+  eye_timeline_key_t *tl_keys = (eye_timeline_key_t *)(tl + 1);
+  char *tl_names = (char *)tl_keys + keys_size;
+  memcpy(tl_keys, keys, keys_size);
+  memcpy(tl_names, names, names_len);
+
+  tl->key_cnt = key_cnt;
+  tl->length_ms = length_ms ? length_ms : end_ms;
+  tl->loop = loop && tl->length_ms > 0;
+  tl->keys = tl_keys;
+  tl->names = tl_names;
+  return tl;
+}
+
+eye_timeline_t *eye_timeline_parse(const char *text, const char **err,
+                                   uint32_t *err_line) {
+  parse_scratch_t *sc = lv_malloc(sizeof(*sc));
+  *err_line = 0;
+  if (!sc) {
+    *err = "out of memory";
+    return NULL;
+  }
+  eye_timeline_t *tl = _parse(text, sc, err, err_line);
+  lv_free(sc);
+  return tl;
+}
+
+eye_timeline_t *eye_timeline_load(const char *path) {
+  lv_fs_file_t f;
+  if (lv_fs_open(&f, path, LV_FS_MODE_RD) != LV_FS_RES_OK) {
+    printf("eye timeline: cannot open %s\n", path);
+    return NULL;
+  }
+
+  char *text = lv_malloc(EYE_TIMELINE_FILE_MAX + 1);
+  uint32_t len = 0;
+  if (text) {
+    uint32_t br;
+    while (len < EYE_TIMELINE_FILE_MAX &&
+           lv_fs_read(&f, text + len, EYE_TIMELINE_FILE_MAX - len, &br) ==
+               LV_FS_RES_OK &&
+           br > 0) {
+      len += br;
+    }
+  }
+  lv_fs_close(&f);
+  if (!text) return NULL;
+
+  eye_timeline_t *tl = NULL;
+  const char *err = "file too large";
+  uint32_t err_line = 0;
+  if (len < EYE_TIMELINE_FILE_MAX) {
+    text[len] = '\0';
+    tl = eye_timeline_parse(text, &err, &err_line);
+  }
+  lv_free(text);
+
+  if (!tl) printf("eye timeline: %s:%u: %s\n", path, err_line, err);
+  return tl;
+}
+
+void eye_timeline_free(eye_timeline_t *tl) { lv_free(tl); }
+
+/* ==================== 播放 ==================== */
+
+static float _ease(uint8_t ease, float t) {
+  switch (ease) {
+    case EYE_TIMELINE_EASE_LINEAR:
+      return t;
+    case EYE_TIMELINE_EASE_IN:
+      return t * t;
+    case EYE_TIMELINE_EASE_OUT:
+      return 1.0f - (1.0f - t) * (1.0f - t);
+    case EYE_TIMELINE_EASE_IN_OUT:
+      return t * t * (3.0f - 2.0f * t);
+    default:
+      return 1.0f;
+  }
+}
+
+/* 通道在 t_ms（相对本轮开始）时的值 */
+static void _channel_eval(const eye_timeline_channel_t *ch, int64_t t_ms,
+                          float *x, float *y) {
+  float k = 1.0f;
+  if (ch->dur_ms && t_ms < ch->t0_ms + (int64_t)ch->dur_ms) {
+    float t = t_ms <= ch->t0_ms ? 0.0f : (float)(t_ms - ch->t0_ms) / ch->dur_ms;
+    k = _ease(ch->ease, t);
+  }
+  *x = ch->x0 + (ch->x1 - ch->x0) * k;
+  *y = ch->y0 + (ch->y1 - ch->y0) * k;
+}
+
+static void _fire_gaze(eye_timeline_playback_t *pb,
+                       const eye_timeline_key_t *key,
+                       const eye_timeline_ops_t *ops, void *user_data) {
+  for (uint32_t e = 0; e < ops->eye_cnt && e < EYE_TIMELINE_EYES; e++) {
+    if (key->eye != EYE_TIMELINE_EYE_ALL && key->eye != e) continue;
+
+    // 从这条时间线在该时刻的值开始过渡，保证连续
+    eye_timeline_channel_t *ch = &pb->gaze[e];
+    if (ch->active) {
+      _channel_eval(ch, key->t_ms, &ch->x0, &ch->y0);
+    } else {
+      ops->get_gaze(e, &ch->x0, &ch->y0, user_data);
+    }
+    ch->active = true;
+    ch->ease = key->ease;
+    ch->t0_ms = (int32_t)key->t_ms;
+    ch->dur_ms = key->ease == EYE_TIMELINE_EASE_STEP ? 0 : key->dur_ms;
+    ch->x1 = (float)key->arg[0];
+    ch->y1 = (float)key->arg[1];
+  }
+}
+
+/* 触发 cursor 到 end 之间时刻不晚于 t_us 的关键帧；回调中取消了自己时返回 false */
+static bool _fire_keys(eye_timeline_playback_t *pb, uint64_t t_us, uint32_t end,
+                       const eye_timeline_ops_t *ops, void *user_data) {
+  const eye_timeline_t *tl = pb->tl;
+
+  while (pb->cursor < end && tl->keys[pb->cursor].t_ms * 1000ULL <= t_us) {
+    const eye_timeline_key_t *key = &tl->keys[pb->cursor++];
+    if (key->op == EYE_TIMELINE_OP_GAZE) {
+      _fire_gaze(pb, key, ops, user_data);
+    } else {
+      const char *name =
+          key->op == EYE_TIMELINE_OP_EMOTION ? tl->names + key->name_off : NULL;
+      ops->event(key, name, user_data);
+    }
+    if (!pb->tl) return false;
+  }
+  return true;
+}
+
+/* 推进一条时间线；返回 false 表示已经播放完 */
+static bool _playback_update(eye_timeline_playback_t *pb, uint64_t now_us,
+                             const eye_timeline_ops_t *ops, void *user_data) {
+  const eye_timeline_t *tl = pb->tl;
+  uint64_t len_us = tl->length_ms * 1000ULL;
+  uint64_t t_us = now_us - pb->start_us;
+  uint32_t first = pb->cursor;  // 本次从这里开始触发
+
+  if (!_fire_keys(pb, t_us, tl->key_cnt, ops, user_data)) return false;
+  if (t_us < len_us) return true;
+  if (!tl->loop) return false;
+
+  // 直接进入当前所在的一轮，落后时整轮跳过，不重放错过的每一轮。
+  // 过渡的起点跟着平移，进行到一半的过渡不受影响
+  uint64_t n = t_us / len_us;
+  uint64_t shift_ms = n * tl->length_ms;
+  pb->start_us += n * len_us;
+  t_us -= n * len_us;
+  for (uint32_t e = 0; e < EYE_TIMELINE_EYES; e++) {
+    eye_timeline_channel_t *ch = &pb->gaze[e];
+    if ((int64_t)ch->t0_ms + ch->dur_ms <= (int64_t)shift_ms) {
+      ch->dur_ms = 0;  // 已经结束的过渡停在终点
+    } else {
+      ch->t0_ms -= (int32_t)shift_ms;
+    }
+  }
+
+  // 每个关键帧本次最多触发一次：上面刚触发过的（first 之后的）不再重复
+  pb->cursor = 0;
+  if (!_fire_keys(pb, t_us, first, ops, user_data)) return false;
+  while (pb->cursor < tl->key_cnt &&
+         tl->keys[pb->cursor].t_ms * 1000ULL <= t_us) {
+    pb->cursor++;
+  }
+  return true;
+}
+
+bool eye_timeline_mixer_play(eye_timeline_mixer_t *mixer,
+                             const eye_timeline_t *tl, uint32_t id,
+                             float weight, uint64_t now_us) {
+  for (uint32_t i = 0; i < EYE_TIMELINE_MAX_PLAYING; i++) {
+    eye_timeline_playback_t *pb = &mixer->pb[i];
+    if (pb->tl) continue;
+    memset(pb, 0, sizeof(*pb));
+    pb->tl = tl;
+    pb->id = id;
+    pb->weight = weight > 0.0f ? weight : 1.0f;
+    pb->start_us = now_us;
+    return true;
+  }
+  return false;
+}
+
+void eye_timeline_mixer_stop(eye_timeline_mixer_t *mixer, uint32_t id) {
+  for (uint32_t i = 0; i < EYE_TIMELINE_MAX_PLAYING; i++) {
+    if (id == 0 || mixer->pb[i].id == id) mixer->pb[i].tl = NULL;
+  }
+}
+
+bool eye_timeline_mixer_playing(const eye_timeline_mixer_t *mixer,
+                                uint32_t id) {
+  if (id == 0) return false;
+  for (uint32_t i = 0; i < EYE_TIMELINE_MAX_PLAYING; i++) {
+    if (mixer->pb[i].tl && mixer->pb[i].id == id) return true;
+  }
+  return false;
+}
+
+void eye_timeline_mixer_update(eye_timeline_mixer_t *mixer, uint64_t now_us,
+                               const eye_timeline_ops_t *ops, void *user_data) {
+  float sum_x[EYE_TIMELINE_EYES] = {0}, sum_y[EYE_TIMELINE_EYES] = {0};
+  float sum_w[EYE_TIMELINE_EYES] = {0};
+
+  for (uint32_t i = 0; i < EYE_TIMELINE_MAX_PLAYING; i++) {
+    eye_timeline_playback_t *pb = &mixer->pb[i];
+    if (!pb->tl) continue;
+
+    bool playing = _playback_update(pb, now_us, ops, user_data);
+    if (!pb->tl) continue;
+
+    // 播放完的时间线最后输出一次终点
+    int64_t t_ms = (int64_t)((now_us - pb->start_us) / 1000);
+    for (uint32_t e = 0; e < EYE_TIMELINE_EYES; e++) {
+      if (!pb->gaze[e].active) continue;
+      float x, y;
+      _channel_eval(&pb->gaze[e], t_ms, &x, &y);
+      sum_x[e] += x * pb->weight;
+      sum_y[e] += y * pb->weight;
+      sum_w[e] += pb->weight;
+    }
+    if (!playing) pb->tl = NULL;
+  }
+
+  for (uint32_t e = 0; e < ops->eye_cnt && e < EYE_TIMELINE_EYES; e++) {
+    if (sum_w[e] == 0.0f) {
+      mixer->out_valid[e] = false;
+      continue;
+    }
+    int32_t x = (int32_t)lroundf(sum_x[e] / sum_w[e]);
+    int32_t y = (int32_t)lroundf(sum_y[e] / sum_w[e]);
+    if (mixer->out_valid[e] && mixer->out_x[e] == x && mixer->out_y[e] == y) {
+      continue;
+    }
+    mixer->out_valid[e] = true;
+    mixer->out_x[e] = x;
+    mixer->out_y[e] = y;
+    ops->gaze(e, x, y, user_data);
+  }
+}
+
+uint64_t eye_timeline_mixer_next_us(const eye_timeline_mixer_t *mixer,
+                                    uint64_t now_us) {
+  uint64_t next = UINT64_MAX;
+
+  for (uint32_t i = 0; i < EYE_TIMELINE_MAX_PLAYING; i++) {
+    const eye_timeline_playback_t *pb = &mixer->pb[i];
+    if (!pb->tl) continue;
+
+    int64_t t_ms = (int64_t)((now_us - pb->start_us) / 1000);
+    for (uint32_t e = 0; e < EYE_TIMELINE_EYES; e++) {
+      const eye_timeline_channel_t *ch = &pb->gaze[e];
+      if (ch->active && t_ms < ch->t0_ms + (int64_t)ch->dur_ms) return now_us;
+    }
+
+    uint32_t at_ms = pb->cursor < pb->tl->key_cnt
+                         ? pb->tl->keys[pb->cursor].t_ms
+                         : pb->tl->length_ms;
+    uint64_t at_us = pb->start_us + at_ms * 1000ULL;
+    if (at_us < next) next = at_us;
+  }
+  return next;
+}
@@ -0,0 +1,149 @@
+#ifndef EYE_TIMELINE_H
+#define EYE_TIMELINE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 时间线
+ *
+ * 把"往右上看、眨两次眼、切换到 proud"这类动作写成关键帧，由渲染线程按帧推进，
+ * 不需要客户端自己 sleep。文本格式一行一个关键帧，# 开始的是注释：
+ *
+ *   length <ms>                   可选，时间线长度，默认为最后一个关键帧结束的时刻
+ *   loop                          可选，播放到结尾后从头开始
+ *   <ms> gaze <eye|all> <x> <y> [<缓动> <时长ms>]
+ *   <ms> point <x> <y> <z>        双眼注视点（mm，见 eye_vergence.h）
+ *   <ms> blink_once
+ *   <ms> blink <interval_ms> <count>
+ *   <ms> emotion <name>
+ *   <ms> lid <eye|all> <pct> [<ms>]  眼皮开度（0 闭上 ~ 100 睁开），可选过渡时长
+ *
+ * 关键帧时刻不能递减。缓动为 step、linear、in、out、in_out，默认 step（直接跳到目标，
+ * 由视线弹簧平滑）；gaze 从这条时间线上一次的目标（没有时为眼睛当前目标）过渡到新目标。
+ *
+ * 加载后是一块连续内存，播放时不再分配。最多 EYE_TIMELINE_MAX_PLAYING 条同时播放：
+ * 离散命令各自触发，同一只眼的视线按权重加权平均，可以随时按 id 取消。
+ */
+
+#define EYE_TIMELINE_MAX_KEYS 256     // 一条时间线最多的关键帧数
+#define EYE_TIMELINE_NAME_MAX 32      // 表情名最大长度（不含结尾 0）
+#define EYE_TIMELINE_FILE_MAX 8192    // 时间线文件最大字节数
+#define EYE_TIMELINE_MAX_PLAYING 4    // 同时播放的时间线条数
+#define EYE_TIMELINE_EYES 4           // 视线通道数，与 EYE_MAX_CNT 一致
+#define EYE_TIMELINE_EYE_ALL 0xFF
+
+typedef enum {
+  EYE_TIMELINE_OP_GAZE,        // arg = x, y
+  EYE_TIMELINE_OP_POINT,       // arg = x, y, z
+  EYE_TIMELINE_OP_BLINK_ONCE,
+  EYE_TIMELINE_OP_BLINK,       // arg = interval_ms, count
+  EYE_TIMELINE_OP_EMOTION,     // 表情名在 names 中的 name_off 处
+  EYE_TIMELINE_OP_LID,         // arg = pct, duration_ms
+} eye_timeline_op_t;
+
+typedef enum {
+  EYE_TIMELINE_EASE_STEP,
+  EYE_TIMELINE_EASE_LINEAR,
+  EYE_TIMELINE_EASE_IN,
+  EYE_TIMELINE_EASE_OUT,
+  EYE_TIMELINE_EASE_IN_OUT,
+} eye_timeline_ease_t;
+
+typedef struct {
+  uint32_t t_ms;         // 相对时间线开始的时刻
+  uint16_t dur_ms;       // 缓动时长
+  uint8_t op;            // eye_timeline_op_t
+  uint8_t eye;           // 眼睛序号或 EYE_TIMELINE_EYE_ALL
+  uint8_t ease;          // eye_timeline_ease_t
+  uint8_t reserved;
+  uint16_t name_off;
+  int32_t arg[3];
+} eye_timeline_key_t;
+
+typedef struct {
+  uint32_t key_cnt;
+  uint32_t length_ms;
+  bool loop;
+  const eye_timeline_key_t *keys;
+  const char *names;     // 表情名，以 0 分隔
+} eye_timeline_t;
+
+/* 解析文本，失败返回 NULL，err/err_line 给出原因和行号 */
+eye_timeline_t *eye_timeline_parse(const char *text, const char **err,
+                                   uint32_t *err_line);
+
+/* 通过 LVGL 文件系统（如 "A:/..."）加载时间线文件，失败返回 NULL 并打印原因 */
+eye_timeline_t *eye_timeline_load(const char *path);
+
+/* 释放时间线（必须已经停止播放） */
+void eye_timeline_free(eye_timeline_t *tl);
+
+/* ==================== 播放 ==================== */
+
+typedef struct {
+  bool active;
+  uint8_t ease;
+  int32_t t0_ms;         // 过渡开始时刻（相对本轮开始，循环时可能为负）
+  uint32_t dur_ms;
+  float x0, y0, x1, y1;
+} eye_timeline_channel_t;
+
+typedef struct {
+  const eye_timeline_t *tl;   // NULL 表示空闲
+  uint32_t id;
+  float weight;
+  uint64_t start_us;          // 本轮开始时刻
+  uint32_t cursor;            // 下一个关键帧
+  eye_timeline_channel_t gaze[EYE_TIMELINE_EYES];
+} eye_timeline_playback_t;
+
+typedef struct {
+  eye_timeline_playback_t pb[EYE_TIMELINE_MAX_PLAYING];
+  bool out_valid[EYE_TIMELINE_EYES];
+  int32_t out_x[EYE_TIMELINE_EYES], out_y[EYE_TIMELINE_EYES];
+} eye_timeline_mixer_t;
+
+typedef struct {
+  uint32_t eye_cnt;
+  /* 输出混合后的视线目标，只在取整后变化时调用 */
+  void (*gaze)(uint32_t eye, int32_t x, int32_t y, void *user_data);
+  /* 读取眼睛当前的视线目标，作为第一次过渡的起点 */
+  void (*get_gaze)(uint32_t eye, float *x, float *y, void *user_data);
+  /* 执行视线以外的关键帧，name 为表情名（其它命令为 NULL） */
+  void (*event)(const eye_timeline_key_t *key, const char *name,
+                void *user_data);
+} eye_timeline_ops_t;
+
+/* 开始播放，weight 为视线混合权重；没有空闲位置返回 false */
+bool eye_timeline_mixer_play(eye_timeline_mixer_t *mixer,
+                             const eye_timeline_t *tl, uint32_t id,
+                             float weight, uint64_t now_us);
+
+/* 取消 id 对应的播放，id 为 0 时取消全部；眼睛停在当前目标 */
+void eye_timeline_mixer_stop(eye_timeline_mixer_t *mixer, uint32_t id);
+
+/* id 对应的播放是否还在进行（没有播放完、没有被取消） */
+bool eye_timeline_mixer_playing(const eye_timeline_mixer_t *mixer,
+                                uint32_t id);
+
+/* 推进到 now_us：依次触发到期的关键帧，输出混合后的视线 */
+void eye_timeline_mixer_update(eye_timeline_mixer_t *mixer, uint64_t now_us,
+                               const eye_timeline_ops_t *ops, void *user_data);
+
+/*
+ * 下一次需要推进的时刻：有视线正在过渡时为 now_us（每帧都要推进），
+ * 没有播放中的时间线时为 UINT64_MAX
+ */
+uint64_t eye_timeline_mixer_next_us(const eye_timeline_mixer_t *mixer,
+                                    uint64_t now_us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EYE_TIMELINE_H */
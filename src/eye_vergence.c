@@ -0,0 +1,24 @@
+#include "eye_vergence.h"
+
+#include <math.h>
+
+void eye_vergence_offset(const eye_vergence_config_t *cfg, uint32_t side,
+                         float max_offset, float x, float y, float z,
+                         float *ox, float *oy) {
+  float ipd = cfg->ipd_mm > 0.0f ? cfg->ipd_mm : EYE_VERGENCE_IPD_MM;
+  float r = cfg->radius_px[side] > 0.0f ? cfg->radius_px[side] : 2.0f * max_offset;
+
+  // 相对这只眼的视线方向
+  float dx = x - (side ? 0.5f : -0.5f) * ipd;
+  float dy = y;
+  float dz = z > EYE_VERGENCE_MIN_Z_MM ? z : EYE_VERGENCE_MIN_Z_MM;
+  float s = r / sqrtf(dx * dx + dy * dy + dz * dz);
+  float px = dx * s;
+  float py = -dy * s;
+
+  // 面板顺时针装歪 roll，图像要逆时针转回来
+  float a = -cfg->roll_deg[side] * (3.14159265f / 180.0f);
+  float c = cosf(a), sn = sinf(a);
+  *ox = px * c - py * sn;
+  *oy = px * sn + py * c;
+}
@@ -0,0 +1,43 @@
+#ifndef EYE_VERGENCE_H
+#define EYE_VERGENCE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 双眼注视点
+ *
+ * 由头部坐标系中的一点算出两只眼各自的瞳孔偏移，近处的点双眼会向内聚合。
+ * 坐标系原点在两眼中间，x 向右、y 向上、z 向前，单位 mm；
+ * 左眼在 (-ipd/2, 0, 0)，右眼在 (ipd/2, 0, 0)。
+ *
+ * 眼球看作半径为 radius_px 的球，瞳孔偏移是视线方向在面板平面上的投影：
+ * offset = radius_px * (dx, -dy) / |d|（面板 y 轴向下）。
+ * 面板绕视轴装歪时（显示旋转之外的角度）用 roll_deg 修正。
+ */
+
+#define EYE_VERGENCE_IPD_MM 63.0f     // 默认瞳距
+#define EYE_VERGENCE_MIN_Z_MM 20.0f   // 注视点至少在眼前这么远
+
+typedef struct {
+  float ipd_mm;           // 瞳距，0 表示默认
+  float radius_px[2];     // 左、右眼球半径（像素），0 表示 2 倍 max_offset（30° 到达边缘）
+  float roll_deg[2];      // 左、右面板绕视轴的安装角度（顺时针）
+} eye_vergence_config_t;
+
+/*
+ * 计算一只眼看向 (x, y, z) 时的瞳孔偏移
+ * side 为 0 表示左眼、1 表示右眼；max_offset 用于默认眼球半径
+ */
+void eye_vergence_offset(const eye_vergence_config_t *cfg, uint32_t side,
+                         float max_offset, float x, float y, float z,
+                         float *ox, float *oy);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EYE_VERGENCE_H */
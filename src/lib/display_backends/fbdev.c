@@ -23,6 +23,7 @@
 #if LV_USE_LINUX_FBDEV
 #include "../simulator_util.h"
 #include "../backends.h"
+#include "../fbdev_display.h"
 
 /*********************
  *      DEFINES
@@ -81,12 +82,29 @@ int backend_init_fbdev(backend_t *backend)
 /**
  * Initialize the fbdev driver
  *
+ * @description the stock LVGL driver is used unless one of
+ * LV_LINUX_FBDEV_ZERO_COPY=1 (render straight into the framebuffer),
+ * LV_LINUX_FBDEV_PAGE_FLIP=1 (flip between two pages) or
+ * LV_LINUX_FBDEV_ASYNC_FLUSH=1 (copy on a worker thread) selects fbdev_display
  * @return the LVGL display
  */
 static lv_display_t *init_fbdev(void)
 {
     const char *device = getenv_default("LV_LINUX_FBDEV_DEVICE", "/dev/fb0");
-    lv_display_t *disp = lv_linux_fbdev_create();
+    fbdev_display_config_t cfg = {0};
+    lv_display_t *disp;
+
+    if (atoi(getenv_default("LV_LINUX_FBDEV_ZERO_COPY", "0"))) {
+        cfg.mode = FBDEV_DISPLAY_MODE_ZERO_COPY;
+    }
+    cfg.page_flip = atoi(getenv_default("LV_LINUX_FBDEV_PAGE_FLIP", "0")) != 0;
+    cfg.async_flush = atoi(getenv_default("LV_LINUX_FBDEV_ASYNC_FLUSH", "0")) != 0;
+
+    if (cfg.mode == FBDEV_DISPLAY_MODE_ZERO_COPY || cfg.page_flip || cfg.async_flush) {
+        return fbdev_display_create(device, &cfg);
+    }
+
+    disp = lv_linux_fbdev_create();
 
     if (disp == NULL) {
         return NULL;
@@ -0,0 +1,916 @@
+/**
+ * @file drm_display.c
+ *
+ * DRM/KMS display driver with atomic page flips
+ *
+ * The connector, a free CRTC it can be routed to and that CRTC's
+ * primary plane are looked up once, then a blocking modeset shows the
+ * first dumb buffer. From then on only the plane's FB_ID changes, with
+ * DRM_MODE_ATOMIC_NONBLOCK | DRM_MODE_PAGE_FLIP_EVENT commits.
+ *
+ * LVGL renders in direct mode into both dumb buffers and keeps them in
+ * sync itself, so nothing is copied. A commit only takes effect at the
+ * next vblank, until then the previous buffer is still scanned out and
+ * must not be drawn into: rendering waits for the flip event if it
+ * arrives before it. With the renders paced to the refresh period this
+ * rarely happens.
+ *
+ * DRM allows only one master per card, so displays on the same card
+ * share the file descriptor. The flip events carry the CRTC, which
+ * routes them back to the display.
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "lvgl/lvgl.h"
+#if LV_USE_LINUX_DRM
+#include <drm_fourcc.h>
+#include <xf86drm.h>
+#include <xf86drmMode.h>
+
+#include "drm_display.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/* Max. number of cards open at the same time */
+#define DRM_DEVICE_MAX 4
+
+/* Max. number of displays per card */
+#define DRM_DEVICE_DISPLAY_MAX 4
+
+/* Longest wait for a flip before rendering anyway */
+#define FLIP_TIMEOUT_MS 100
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef struct drm_display_t drm_display_t;
+
+typedef struct {
+    char path[64];
+    int fd;
+    uint32_t ref_cnt;
+    uint32_t used_crtcs;               /* Bit mask of CRTC indices in use */
+    uint32_t used_connectors[DRM_DEVICE_DISPLAY_MAX];
+    drm_display_t *displays[DRM_DEVICE_DISPLAY_MAX];
+} drm_device_t;
+
+typedef struct {
+    uint32_t handle;
+    uint32_t pitch;
+    uint64_t size;
+    uint32_t fb_id;
+    uint8_t *map;
+} dumb_buf_t;
+
+/* Property IDs of the objects changed by the commits */
+typedef struct {
+    uint32_t conn_crtc_id;
+    uint32_t crtc_mode_id;
+    uint32_t crtc_active;
+    uint32_t fb_id;
+    uint32_t crtc_id;
+    uint32_t src_x;
+    uint32_t src_y;
+    uint32_t src_w;
+    uint32_t src_h;
+    uint32_t crtc_x;
+    uint32_t crtc_y;
+    uint32_t crtc_w;
+    uint32_t crtc_h;
+} drm_props_t;
+
+struct drm_display_t {
+    drm_device_t *dev;
+    uint32_t slot;                     /* Index in dev->displays */
+    uint32_t connector_id;
+    uint32_t crtc_id;
+    uint32_t crtc_index;
+    uint32_t plane_id;
+    drmModeModeInfo mode;
+    uint32_t mode_blob_id;
+    drm_props_t props;
+    dumb_buf_t bufs[2];
+    uint32_t front;                    /* Buffer being scanned out */
+    uint32_t pending;                  /* Completed buffer, waiting for commit or flip */
+    bool present_pending;              /* A completed frame waits for drm_display_commit */
+    bool flip_pending;                 /* Committed, flip event not received yet */
+    bool deferred_present;             /* Leave the commit to drm_display_commit */
+    uint64_t commit_us;
+    drm_display_stats_t stats;
+    lv_display_t *disp;
+};
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static drm_device_t *device_get(const char *path);
+static void device_put(drm_device_t *dev);
+static bool find_pipe(drm_display_t *dsc, const drm_display_config_t *cfg);
+static bool find_connector(drm_display_t *dsc, drmModeRes *res, const drm_display_config_t *cfg,
+                           drmModeConnector **conn_out);
+static bool find_crtc(drm_display_t *dsc, drmModeRes *res, drmModeConnector *conn);
+static bool find_plane(drm_display_t *dsc, uint32_t fourcc);
+static bool plane_is_primary(int fd, uint32_t plane_id);
+static uint32_t get_prop_id(int fd, uint32_t obj_id, uint32_t obj_type, const char *name);
+static bool get_props(drm_display_t *dsc);
+static bool dumb_buf_create(drm_display_t *dsc, dumb_buf_t *buf, uint32_t fourcc, uint32_t bpp);
+static void dumb_buf_destroy(drm_display_t *dsc, dumb_buf_t *buf);
+static bool modeset(drm_display_t *dsc);
+static void add_plane_props(drmModeAtomicReq *req, drm_display_t *dsc, uint32_t buf);
+static void flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map);
+static void render_start_event_cb(lv_event_t *e);
+static void wait_flip(drm_display_t *dsc);
+static void page_flip_handler(int fd, unsigned int sequence, unsigned int tv_sec,
+                              unsigned int tv_usec, unsigned int crtc_id, void *user_data);
+static void delete_event_cb(lv_event_t *e);
+static uint64_t now_us(void);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static drm_device_t devices[DRM_DEVICE_MAX];
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+lv_display_t *drm_display_create(const char *path, const drm_display_config_t *cfg)
+{
+    drm_display_t *dsc;
+    lv_display_t *disp;
+    lv_color_format_t cf = cfg->color_format;
+    uint32_t fourcc;
+    uint32_t i;
+
+    if (cf == LV_COLOR_FORMAT_UNKNOWN) {
+        cf = LV_COLOR_FORMAT_XRGB8888;
+    }
+    if (cf == LV_COLOR_FORMAT_RGB565) {
+        fourcc = DRM_FORMAT_RGB565;
+    } else if (cf == LV_COLOR_FORMAT_XRGB8888) {
+        fourcc = DRM_FORMAT_XRGB8888;
+    } else {
+        LV_LOG_ERROR("Unsupported color format %d", cf);
+        return NULL;
+    }
+
+    dsc = lv_malloc_zeroed(sizeof(drm_display_t));
+    if (dsc == NULL) {
+        return NULL;
+    }
+
+    dsc->dev = device_get(path);
+    if (dsc->dev == NULL) {
+        goto err_free;
+    }
+
+    if (!find_pipe(dsc, cfg)) {
+        goto err_put;
+    }
+    if (!find_plane(dsc, fourcc) || !get_props(dsc)) {
+        goto err_pipe;
+    }
+
+    for (i = 0; i < 2; i++) {
+        if (!dumb_buf_create(dsc, &dsc->bufs[i], fourcc, lv_color_format_get_bpp(cf))) {
+            goto err_bufs;
+        }
+    }
+
+    if (drmModeCreatePropertyBlob(dsc->dev->fd, &dsc->mode, sizeof(dsc->mode),
+                                  &dsc->mode_blob_id) != 0 ||
+        !modeset(dsc)) {
+        LV_LOG_ERROR("Cannot set mode %s on %s", dsc->mode.name, path);
+        goto err_bufs;
+    }
+
+    disp = lv_display_create(dsc->mode.hdisplay, dsc->mode.vdisplay);
+    if (disp == NULL) {
+        goto err_bufs;
+    }
+
+    dsc->disp = disp;
+    dsc->dev->displays[dsc->slot] = dsc;
+    lv_display_set_driver_data(disp, dsc);
+    lv_display_set_color_format(disp, cf);
+    lv_display_set_rotation(disp, cfg->rotation);
+    lv_display_set_flush_cb(disp, flush_cb);
+    lv_display_add_event_cb(disp, render_start_event_cb, LV_EVENT_RENDER_START, NULL);
+    lv_display_add_event_cb(disp, delete_event_cb, LV_EVENT_DELETE, NULL);
+
+    /* Start on the back buffer, the front one is being scanned out */
+    lv_display_set_buffers_with_stride(disp, dsc->bufs[1].map, dsc->bufs[0].map,
+                                       (uint32_t)dsc->bufs[0].size, dsc->bufs[0].pitch,
+                                       LV_DISPLAY_RENDER_MODE_DIRECT);
+
+    LV_LOG_INFO("%s: connector %u, crtc %u, plane %u, %s", path, dsc->connector_id,
+                dsc->crtc_id, dsc->plane_id, dsc->mode.name);
+    return disp;
+
+err_bufs:
+    for (i = 0; i < 2; i++) {
+        dumb_buf_destroy(dsc, &dsc->bufs[i]);
+    }
+    if (dsc->mode_blob_id) {
+        drmModeDestroyPropertyBlob(dsc->dev->fd, dsc->mode_blob_id);
+    }
+err_pipe:
+    dsc->dev->used_crtcs &= ~(1u << dsc->crtc_index);
+    dsc->dev->used_connectors[dsc->slot] = 0;
+err_put:
+    device_put(dsc->dev);
+err_free:
+    lv_free(dsc);
+    return NULL;
+}
+
+int drm_display_get_fd(lv_display_t *disp)
+{
+    drm_display_t *dsc = lv_display_get_driver_data(disp);
+
+    return dsc->dev->fd;
+}
+
+void drm_display_handle_events(lv_display_t *disp)
+{
+    drm_display_t *dsc = lv_display_get_driver_data(disp);
+    drmEventContext ctx = {
+        .version = DRM_EVENT_CONTEXT_VERSION,
+        .page_flip_handler2 = page_flip_handler,
+    };
+
+    drmHandleEvent(dsc->dev->fd, &ctx);
+}
+
+uint32_t drm_display_get_refresh_period_us(lv_display_t *disp)
+{
+    drm_display_t *dsc = lv_display_get_driver_data(disp);
+    uint64_t pixels = (uint64_t)dsc->mode.htotal * dsc->mode.vtotal;
+
+    /* The mode clock is in kHz */
+    if (dsc->mode.clock == 0) {
+        return 0;
+    }
+    return (uint32_t)(pixels * 1000 / dsc->mode.clock);
+}
+
+void drm_display_set_deferred_present(lv_display_t *disp, bool en)
+{
+    drm_display_t *dsc = lv_display_get_driver_data(disp);
+
+    dsc->deferred_present = en;
+    if (!en) {
+        drm_display_commit(&disp, 1);
+    }
+}
+
+bool drm_display_is_present_pending(lv_display_t *disp)
+{
+    drm_display_t *dsc = lv_display_get_driver_data(disp);
+
+    return dsc->present_pending;
+}
+
+uint32_t drm_display_commit(lv_display_t *const *disps, uint32_t cnt)
+{
+    drm_display_t *batch[DRM_DEVICE_DISPLAY_MAX];
+    bool done[DRM_DEVICE_DISPLAY_MAX * DRM_DEVICE_MAX] = {false};
+    uint32_t committed = 0;
+    uint32_t i;
+    uint32_t j;
+
+    if (cnt > LV_ARRAYLEN(done)) {
+        cnt = LV_ARRAYLEN(done);
+    }
+
+    /* One commit per card with every display that has a frame ready */
+    for (i = 0; i < cnt; i++) {
+        drm_display_t *first = lv_display_get_driver_data(disps[i]);
+        drmModeAtomicReq *req;
+        uint32_t batch_cnt = 0;
+        uint64_t now;
+
+        if (done[i]) {
+            continue;
+        }
+
+        for (j = i; j < cnt; j++) {
+            drm_display_t *dsc = lv_display_get_driver_data(disps[j]);
+            if (done[j] || dsc->dev != first->dev) {
+                continue;
+            }
+            done[j] = true;
+            if (!dsc->present_pending) {
+                continue;
+            }
+            if (dsc->flip_pending || batch_cnt == LV_ARRAYLEN(batch)) {
+                /* Stays pending for the next commit */
+                dsc->stats.commit_skip_cnt++;
+                continue;
+            }
+            batch[batch_cnt++] = dsc;
+        }
+
+        if (batch_cnt == 0) {
+            continue;
+        }
+
+        req = drmModeAtomicAlloc();
+        if (req == NULL) {
+            continue;
+        }
+        for (j = 0; j < batch_cnt; j++) {
+            add_plane_props(req, batch[j], batch[j]->pending);
+        }
+
+        if (drmModeAtomicCommit(first->dev->fd, req,
+                                DRM_MODE_ATOMIC_NONBLOCK | DRM_MODE_PAGE_FLIP_EVENT,
+                                first->dev) != 0) {
+            LV_LOG_WARN("Atomic commit failed: %s", strerror(errno));
+            drmModeAtomicFree(req);
+            continue;
+        }
+        drmModeAtomicFree(req);
+
+        now = now_us();
+        for (j = 0; j < batch_cnt; j++) {
+            batch[j]->present_pending = false;
+            batch[j]->flip_pending = true;
+            batch[j]->commit_us = now;
+            batch[j]->stats.commit_cnt++;
+        }
+        committed += batch_cnt;
+    }
+
+    return committed;
+}
+
+void drm_display_get_stats(lv_display_t *disp, drm_display_stats_t *stats, bool reset)
+{
+    drm_display_t *dsc = lv_display_get_driver_data(disp);
+    uint64_t vblank_us = dsc->stats.vblank_us;
+
+    *stats = dsc->stats;
+    if (reset) {
+        memset(&dsc->stats, 0, sizeof(dsc->stats));
+        dsc->stats.vblank_us = vblank_us;
+    }
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Open a card or take another reference to it
+ * @return the device or NULL on error
+ */
+static drm_device_t *device_get(const char *path)
+{
+    drm_device_t *free_dev = NULL;
+    uint64_t cap = 0;
+    uint32_t i;
+
+    for (i = 0; i < DRM_DEVICE_MAX; i++) {
+        if (devices[i].ref_cnt > 0 && strcmp(devices[i].path, path) == 0) {
+            devices[i].ref_cnt++;
+            return &devices[i];
+        }
+        if (devices[i].ref_cnt == 0 && free_dev == NULL) {
+            free_dev = &devices[i];
+        }
+    }
+
+    if (free_dev == NULL) {
+        LV_LOG_ERROR("Too many DRM cards");
+        return NULL;
+    }
+
+    memset(free_dev, 0, sizeof(*free_dev));
+    free_dev->fd = open(path, O_RDWR | O_CLOEXEC);
+    if (free_dev->fd < 0) {
+        LV_LOG_ERROR("Cannot open %s: %s", path, strerror(errno));
+        return NULL;
+    }
+
+    if (drmGetCap(free_dev->fd, DRM_CAP_DUMB_BUFFER, &cap) != 0 || cap == 0 ||
+        drmSetClientCap(free_dev->fd, DRM_CLIENT_CAP_UNIVERSAL_PLANES, 1) != 0 ||
+        drmSetClientCap(free_dev->fd, DRM_CLIENT_CAP_ATOMIC, 1) != 0) {
+        LV_LOG_ERROR("%s doesn't support dumb buffers or atomic modesetting", path);
+        close(free_dev->fd);
+        return NULL;
+    }
+
+    lv_strlcpy(free_dev->path, path, sizeof(free_dev->path));
+    free_dev->ref_cnt = 1;
+    return free_dev;
+}
+
+static void device_put(drm_device_t *dev)
+{
+    if (--dev->ref_cnt == 0) {
+        close(dev->fd);
+        dev->fd = -1;
+    }
+}
+
+/**
+ * Pick the connector, its mode and a CRTC that isn't used yet
+ */
+static bool find_pipe(drm_display_t *dsc, const drm_display_config_t *cfg)
+{
+    drmModeRes *res;
+    drmModeConnector *conn = NULL;
+    bool ok = false;
+    uint32_t slot;
+
+    for (slot = 0; slot < DRM_DEVICE_DISPLAY_MAX; slot++) {
+        if (dsc->dev->used_connectors[slot] == 0) {
+            break;
+        }
+    }
+    if (slot == DRM_DEVICE_DISPLAY_MAX) {
+        LV_LOG_ERROR("Too many displays on %s", dsc->dev->path);
+        return false;
+    }
+    dsc->slot = slot;
+
+    res = drmModeGetResources(dsc->dev->fd);
+    if (res == NULL) {
+        LV_LOG_ERROR("Cannot get the resources of %s", dsc->dev->path);
+        return false;
+    }
+
+    if (find_connector(dsc, res, cfg, &conn) && find_crtc(dsc, res, conn)) {
+        dsc->dev->used_connectors[slot] = dsc->connector_id;
+        dsc->dev->used_crtcs |= 1u << dsc->crtc_index;
+        ok = true;
+    }
+
+    if (conn) {
+        drmModeFreeConnector(conn);
+    }
+    drmModeFreeResources(res);
+    return ok;
+}
+
+static bool find_connector(drm_display_t *dsc, drmModeRes *res, const drm_display_config_t *cfg,
+                           drmModeConnector **conn_out)
+{
+    int i;
+    int m;
+    uint32_t s;
+
+    for (i = 0; i < res->count_connectors; i++) {
+        drmModeConnector *conn;
+        bool used = false;
+
+        if (cfg->connector_id && res->connectors[i] != cfg->connector_id) {
+            continue;
+        }
+        for (s = 0; s < DRM_DEVICE_DISPLAY_MAX; s++) {
+            used |= dsc->dev->used_connectors[s] == res->connectors[i];
+        }
+        if (used) {
+            continue;
+        }
+
+        conn = drmModeGetConnector(dsc->dev->fd, res->connectors[i]);
+        if (conn == NULL) {
+            continue;
+        }
+        if (conn->connection != DRM_MODE_CONNECTED || conn->count_modes == 0) {
+            drmModeFreeConnector(conn);
+            continue;
+        }
+
+        /* A mode of the requested size, else the preferred one */
+        dsc->mode = conn->modes[0];
+        for (m = 0; m < conn->count_modes; m++) {
+            const drmModeModeInfo *mode = &conn->modes[m];
+            if (cfg->hor_res || cfg->ver_res) {
+                if (mode->hdisplay == cfg->hor_res && mode->vdisplay == cfg->ver_res) {
+                    dsc->mode = *mode;
+                    break;
+                }
+            } else if (mode->type & DRM_MODE_TYPE_PREFERRED) {
+                dsc->mode = *mode;
+                break;
+            }
+        }
+        if ((cfg->hor_res || cfg->ver_res) &&
+            (dsc->mode.hdisplay != cfg->hor_res || dsc->mode.vdisplay != cfg->ver_res)) {
+            LV_LOG_WARN("No %dx%d mode on connector %u, using %s", (int)cfg->hor_res,
+                        (int)cfg->ver_res, conn->connector_id, dsc->mode.name);
+        }
+
+        dsc->connector_id = conn->connector_id;
+        *conn_out = conn;
+        return true;
+    }
+
+    LV_LOG_ERROR("No free connected connector on %s", dsc->dev->path);
+    return false;
+}
+
+static bool find_crtc(drm_display_t *dsc, drmModeRes *res, drmModeConnector *conn)
+{
+    int i;
+    int c;
+
+    for (i = 0; i < conn->count_encoders; i++) {
+        drmModeEncoder *enc = drmModeGetEncoder(dsc->dev->fd, conn->encoders[i]);
+        uint32_t possible;
+
+        if (enc == NULL) {
+            continue;
+        }
+        possible = enc->possible_crtcs & ~dsc->dev->used_crtcs;
+        drmModeFreeEncoder(enc);
+
+        for (c = 0; c < res->count_crtcs && c < 32; c++) {
+            if (possible & (1u << c)) {
+                dsc->crtc_id = res->crtcs[c];
+                dsc->crtc_index = (uint32_t)c;
+                return true;
+            }
+        }
+    }
+
+    LV_LOG_ERROR("No free CRTC for connector %u", conn->connector_id);
+    return false;
+}
+
+/**
+ * Find the primary plane of the CRTC that can scan out the format
+ */
+static bool find_plane(drm_display_t *dsc, uint32_t fourcc)
+{
+    drmModePlaneRes *planes = drmModeGetPlaneResources(dsc->dev->fd);
+    uint32_t i;
+    uint32_t f;
+
+    if (planes == NULL) {
+        return false;
+    }
+
+    for (i = 0; i < planes->count_planes && dsc->plane_id == 0; i++) {
+        drmModePlane *plane = drmModeGetPlane(dsc->dev->fd, planes->planes[i]);
+        bool format_ok = false;
+
+        if (plane == NULL) {
+            continue;
+        }
+        for (f = 0; f < plane->count_formats; f++) {
+            format_ok |= plane->formats[f] == fourcc;
+        }
+        if (format_ok && (plane->possible_crtcs & (1u << dsc->crtc_index)) &&
+            plane_is_primary(dsc->dev->fd, plane->plane_id)) {
+            dsc->plane_id = plane->plane_id;
+        }
+        drmModeFreePlane(plane);
+    }
+    drmModeFreePlaneResources(planes);
+
+    if (dsc->plane_id == 0) {
+        LV_LOG_ERROR("No primary plane for CRTC %u supports the color format", dsc->crtc_id);
+        return false;
+    }
+    return true;
+}
+
+static bool plane_is_primary(int fd, uint32_t plane_id)
+{
+    drmModeObjectProperties *props = drmModeObjectGetProperties(fd, plane_id, DRM_MODE_OBJECT_PLANE);
+    bool primary = false;
+    uint32_t i;
+
+    if (props == NULL) {
+        return false;
+    }
+
+    for (i = 0; i < props->count_props; i++) {
+        drmModePropertyRes *prop = drmModeGetProperty(fd, props->props[i]);
+        if (prop == NULL) {
+            continue;
+        }
+        if (strcmp(prop->name, "type") == 0) {
+            primary = props->prop_values[i] == DRM_PLANE_TYPE_PRIMARY;
+        }
+        drmModeFreeProperty(prop);
+    }
+    drmModeFreeObjectProperties(props);
+    return primary;
+}
+
+static uint32_t get_prop_id(int fd, uint32_t obj_id, uint32_t obj_type, const char *name)
+{
+    drmModeObjectProperties *props = drmModeObjectGetProperties(fd, obj_id, obj_type);
+    uint32_t id = 0;
+    uint32_t i;
+
+    if (props == NULL) {
+        return 0;
+    }
+
+    for (i = 0; i < props->count_props && id == 0; i++) {
+        drmModePropertyRes *prop = drmModeGetProperty(fd, props->props[i]);
+        if (prop == NULL) {
+            continue;
+        }
+        if (strcmp(prop->name, name) == 0) {
+            id = prop->prop_id;
+        }
+        drmModeFreeProperty(prop);
+    }
+    drmModeFreeObjectProperties(props);
+    return id;
+}
+
+static bool get_props(drm_display_t *dsc)
+{
+    int fd = dsc->dev->fd;
+    drm_props_t *p = &dsc->props;
+
+    p->conn_crtc_id = get_prop_id(fd, dsc->connector_id, DRM_MODE_OBJECT_CONNECTOR, "CRTC_ID");
+    p->crtc_mode_id = get_prop_id(fd, dsc->crtc_id, DRM_MODE_OBJECT_CRTC, "MODE_ID");
+    p->crtc_active = get_prop_id(fd, dsc->crtc_id, DRM_MODE_OBJECT_CRTC, "ACTIVE");
+    p->fb_id = get_prop_id(fd, dsc->plane_id, DRM_MODE_OBJECT_PLANE, "FB_ID");
+    p->crtc_id = get_prop_id(fd, dsc->plane_id, DRM_MODE_OBJECT_PLANE, "CRTC_ID");
+    p->src_x = get_prop_id(fd, dsc->plane_id, DRM_MODE_OBJECT_PLANE, "SRC_X");
+    p->src_y = get_prop_id(fd, dsc->plane_id, DRM_MODE_OBJECT_PLANE, "SRC_Y");
+    p->src_w = get_prop_id(fd, dsc->plane_id, DRM_MODE_OBJECT_PLANE, "SRC_W");
+    p->src_h = get_prop_id(fd, dsc->plane_id, DRM_MODE_OBJECT_PLANE, "SRC_H");
+    p->crtc_x = get_prop_id(fd, dsc->plane_id, DRM_MODE_OBJECT_PLANE, "CRTC_X");
+    p->crtc_y = get_prop_id(fd, dsc->plane_id, DRM_MODE_OBJECT_PLANE, "CRTC_Y");
+    p->crtc_w = get_prop_id(fd, dsc->plane_id, DRM_MODE_OBJECT_PLANE, "CRTC_W");
+    p->crtc_h = get_prop_id(fd, dsc->plane_id, DRM_MODE_OBJECT_PLANE, "CRTC_H");
+
+    if (!p->conn_crtc_id || !p->crtc_mode_id || !p->crtc_active || !p->fb_id ||
+        !p->crtc_id || !p->src_x || !p->src_y || !p->src_w || !p->src_h ||
+        !p->crtc_x || !p->crtc_y || !p->crtc_w || !p->crtc_h) {
+        LV_LOG_ERROR("Missing atomic properties on CRTC %u", dsc->crtc_id);
+        return false;
+    }
+    return true;
+}
+
+static bool dumb_buf_create(drm_display_t *dsc, dumb_buf_t *buf, uint32_t fourcc, uint32_t bpp)
+{
+    int fd = dsc->dev->fd;
+    struct drm_mode_create_dumb create = {
+        .width = dsc->mode.hdisplay,
+        .height = dsc->mode.vdisplay,
+        .bpp = bpp,
+    };
+    struct drm_mode_map_dumb map = {0};
+    uint32_t handles[4] = {0};
+    uint32_t pitches[4] = {0};
+    uint32_t offsets[4] = {0};
+
+    if (drmIoctl(fd, DRM_IOCTL_MODE_CREATE_DUMB, &create) != 0) {
+        LV_LOG_ERROR("Cannot create a dumb buffer: %s", strerror(errno));
+        return false;
+    }
+    buf->handle = create.handle;
+    buf->pitch = create.pitch;
+    buf->size = create.size;
+
+    handles[0] = buf->handle;
+    pitches[0] = buf->pitch;
+    if (drmModeAddFB2(fd, create.width, create.height, fourcc, handles, pitches, offsets,
+                      &buf->fb_id, 0) != 0) {
+        LV_LOG_ERROR("Cannot add a framebuffer: %s", strerror(errno));
+        return false;
+    }
+
+    map.handle = buf->handle;
+    if (drmIoctl(fd, DRM_IOCTL_MODE_MAP_DUMB, &map) != 0) {
+        return false;
+    }
+    buf->map = mmap(NULL, buf->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, (off_t)map.offset);
+    if (buf->map == MAP_FAILED) {
+        buf->map = NULL;
+        LV_LOG_ERROR("Cannot map a dumb buffer: %s", strerror(errno));
+        return false;
+    }
+
+    memset(buf->map, 0, buf->size);
+    return true;
+}
+
+static void dumb_buf_destroy(drm_display_t *dsc, dumb_buf_t *buf)
+{
+    struct drm_mode_destroy_dumb destroy = {.handle = buf->handle};
+
+    if (buf->map) {
+        munmap(buf->map, buf->size);
+    }
+    if (buf->fb_id) {
+        drmModeRmFB(dsc->dev->fd, buf->fb_id);
+    }
+    if (buf->handle) {
+        drmIoctl(dsc->dev->fd, DRM_IOCTL_MODE_DESTROY_DUMB, &destroy);
+    }
+    memset(buf, 0, sizeof(*buf));
+}
+
+/**
+ * Route the connector through the CRTC and show the first buffer
+ */
+static bool modeset(drm_display_t *dsc)
+{
+    drmModeAtomicReq *req = drmModeAtomicAlloc();
+    int ret;
+
+    if (req == NULL) {
+        return false;
+    }
+
+    drmModeAtomicAddProperty(req, dsc->connector_id, dsc->props.conn_crtc_id, dsc->crtc_id);
+    drmModeAtomicAddProperty(req, dsc->crtc_id, dsc->props.crtc_mode_id, dsc->mode_blob_id);
+    drmModeAtomicAddProperty(req, dsc->crtc_id, dsc->props.crtc_active, 1);
+    add_plane_props(req, dsc, 0);
+
+    ret = drmModeAtomicCommit(dsc->dev->fd, req, DRM_MODE_ATOMIC_ALLOW_MODESET, NULL);
+    drmModeAtomicFree(req);
+
+    dsc->front = 0;
+    return ret == 0;
+}
+
+static void add_plane_props(drmModeAtomicReq *req, drm_display_t *dsc, uint32_t buf)
+{
+    const drm_props_t *p = &dsc->props;
+    uint32_t w = dsc->mode.hdisplay;
+    uint32_t h = dsc->mode.vdisplay;
+
+    drmModeAtomicAddProperty(req, dsc->plane_id, p->fb_id, dsc->bufs[buf].fb_id);
+    drmModeAtomicAddProperty(req, dsc->plane_id, p->crtc_id, dsc->crtc_id);
+    /* The source rectangle is in 16.16 fixed point */
+    drmModeAtomicAddProperty(req, dsc->plane_id, p->src_x, 0);
+    drmModeAtomicAddProperty(req, dsc->plane_id, p->src_y, 0);
+    drmModeAtomicAddProperty(req, dsc->plane_id, p->src_w, (uint64_t)w << 16);
+    drmModeAtomicAddProperty(req, dsc->plane_id, p->src_h, (uint64_t)h << 16);
+    drmModeAtomicAddProperty(req, dsc->plane_id, p->crtc_x, 0);
+    drmModeAtomicAddProperty(req, dsc->plane_id, p->crtc_y, 0);
+    drmModeAtomicAddProperty(req, dsc->plane_id, p->crtc_w, w);
+    drmModeAtomicAddProperty(req, dsc->plane_id, p->crtc_h, h);
+}
+
+/**
+ * The pixels are already in the dumb buffer, flip once the frame is complete
+ * (or later by drm_display_commit in deferred mode)
+ */
+static void flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map)
+{
+    drm_display_t *dsc = lv_display_get_driver_data(disp);
+
+    LV_UNUSED(area);
+
+    if (lv_display_flush_is_last(disp)) {
+        /* LVGL alternates between the buffers, show the one just rendered */
+        dsc->pending = (px_map == dsc->bufs[0].map) ? 0 : 1;
+        dsc->present_pending = true;
+        dsc->stats.frame_cnt++;
+        if (!dsc->deferred_present) {
+            drm_display_commit(&disp, 1);
+        }
+    }
+
+    lv_display_flush_ready(disp);
+}
+
+/**
+ * LVGL is about to draw into the buffer that was scanned out until the
+ * last flip, make sure that flip has happened
+ */
+static void render_start_event_cb(lv_event_t *e)
+{
+    lv_display_t *disp = lv_event_get_target(e);
+    drm_display_t *dsc = lv_display_get_driver_data(disp);
+
+    /* An uncommitted frame would be overwritten by the next one */
+    if (dsc->present_pending) {
+        drm_display_commit(&disp, 1);
+    }
+    if (dsc->flip_pending) {
+        dsc->stats.render_wait_cnt++;
+        wait_flip(dsc);
+    }
+}
+
+static void wait_flip(drm_display_t *dsc)
+{
+    struct pollfd pfd = {.fd = dsc->dev->fd, .events = POLLIN};
+    uint64_t start = now_us();
+    drmEventContext ctx = {
+        .version = DRM_EVENT_CONTEXT_VERSION,
+        .page_flip_handler2 = page_flip_handler,
+    };
+
+    while (dsc->flip_pending) {
+        uint64_t elapsed_ms = (now_us() - start) / 1000;
+        int ret;
+
+        if (elapsed_ms >= FLIP_TIMEOUT_MS) {
+            LV_LOG_WARN("Flip on CRTC %u timed out", dsc->crtc_id);
+            dsc->flip_pending = false;
+            break;
+        }
+
+        ret = poll(&pfd, 1, (int)(FLIP_TIMEOUT_MS - elapsed_ms));
+        if (ret > 0) {
+            drmHandleEvent(dsc->dev->fd, &ctx);
+        } else if (ret < 0 && errno != EINTR) {
+            dsc->flip_pending = false;
+        }
+    }
+}
+
+static void page_flip_handler(int fd, unsigned int sequence, unsigned int tv_sec,
+                              unsigned int tv_usec, unsigned int crtc_id, void *user_data)
+{
+    drm_device_t *dev = user_data;
+    uint32_t i;
+
+    LV_UNUSED(fd);
+    LV_UNUSED(sequence);
+
+    for (i = 0; i < DRM_DEVICE_DISPLAY_MAX; i++) {
+        drm_display_t *dsc = dev->displays[i];
+        uint64_t latency;
+
+        if (dsc == NULL || dsc->crtc_id != crtc_id || !dsc->flip_pending) {
+            continue;
+        }
+
+        dsc->flip_pending = false;
+        dsc->front = dsc->pending;
+
+        latency = now_us() - dsc->commit_us;
+        dsc->stats.flip_cnt++;
+        dsc->stats.flip_latency_us += latency;
+        if (latency > dsc->stats.flip_latency_max_us) {
+            dsc->stats.flip_latency_max_us = (uint32_t)latency;
+        }
+        /* Event timestamps are CLOCK_MONOTONIC */
+        dsc->stats.vblank_us = (uint64_t)tv_sec * 1000000 + tv_usec;
+    }
+}
+
+static void delete_event_cb(lv_event_t *e)
+{
+    lv_display_t *disp = lv_event_get_target(e);
+    drm_display_t *dsc = lv_display_get_driver_data(disp);
+    drm_device_t *dev;
+    uint32_t i;
+
+    if (dsc == NULL) {
+        return;
+    }
+
+    /* The buffer being flipped to must not be freed under the scan-out */
+    if (dsc->flip_pending) {
+        wait_flip(dsc);
+    }
+
+    dev = dsc->dev;
+    for (i = 0; i < 2; i++) {
+        dumb_buf_destroy(dsc, &dsc->bufs[i]);
+    }
+    drmModeDestroyPropertyBlob(dev->fd, dsc->mode_blob_id);
+    dev->used_crtcs &= ~(1u << dsc->crtc_index);
+    dev->used_connectors[dsc->slot] = 0;
+    dev->displays[dsc->slot] = NULL;
+    device_put(dev);
+
+    lv_free(dsc);
+    lv_display_set_driver_data(disp, NULL);
+}
+
+static uint64_t now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+#endif /*LV_USE_LINUX_DRM*/
@@ -0,0 +1,133 @@
+/**
+ * @file drm_display.h
+ *
+ * DRM/KMS display driver with atomic page flips
+ *
+ * Each display drives one connector through its own CRTC and primary
+ * plane. LVGL renders straight into two mmap'd dumb buffers, which are
+ * flipped with non-blocking atomic commits. Completed flips are reported
+ * as events on the card's file descriptor, so the caller can wait for
+ * them in its own poll loop instead of polling.
+ *
+ * Several displays on the same card share one file descriptor, and
+ * their pending frames can be flipped together in a single commit.
+ *
+ */
+
+#ifndef DRM_DISPLAY_H
+#define DRM_DISPLAY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdint.h>
+
+#include "lvgl/lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef struct {
+    uint32_t connector_id;             /* 0 to use the next connected connector */
+    int32_t hor_res;                   /* 0 to use the preferred mode */
+    int32_t ver_res;                   /* 0 to use the preferred mode */
+    lv_display_rotation_t rotation;    /* Rotation of the panel */
+    lv_color_format_t color_format;    /* RGB565 or XRGB8888, LV_COLOR_FORMAT_UNKNOWN for XRGB8888 */
+} drm_display_config_t;
+
+/* Flip statistics, accumulated since creation or the last reset */
+typedef struct {
+    uint32_t frame_cnt;                /* Number of completed frames */
+    uint32_t commit_cnt;               /* Atomic commits including this display */
+    uint32_t flip_cnt;                 /* Completed flips */
+    uint64_t flip_latency_us;          /* Total time from commit to flip */
+    uint32_t flip_latency_max_us;      /* Longest time from commit to flip */
+    uint32_t render_wait_cnt;          /* Renders that had to wait for a flip */
+    uint32_t commit_skip_cnt;          /* Ready frames not committed because a flip was pending */
+    uint64_t vblank_us;                /* Monotonic time of the last flip */
+} drm_display_stats_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Create a display on a DRM card
+ * @param path the card device, e.g. /dev/dri/card0
+ * @param cfg  the display configuration
+ * @return the LVGL display or NULL on error
+ */
+lv_display_t *drm_display_create(const char *path, const drm_display_config_t *cfg);
+
+/**
+ * Get the file descriptor that signals completed flips
+ * @param disp a display created with drm_display_create
+ * @return the card's file descriptor, shared by displays on the same card
+ */
+int drm_display_get_fd(lv_display_t *disp);
+
+/**
+ * Dispatch the pending flip events of the display's card
+ * @param disp a display created with drm_display_create
+ * @description call when drm_display_get_fd becomes readable
+ */
+void drm_display_handle_events(lv_display_t *disp);
+
+/**
+ * Get the refresh period of the current mode
+ * @param disp a display created with drm_display_create
+ * @return the period in microseconds
+ */
+uint32_t drm_display_get_refresh_period_us(lv_display_t *disp);
+
+/**
+ * Defer flipping completed frames until drm_display_commit is called
+ * @param disp a display created with drm_display_create
+ * @param en   true: defer, false: commit as soon as a frame is flushed
+ */
+void drm_display_set_deferred_present(lv_display_t *disp, bool en);
+
+/**
+ * Check whether a completed frame waits to be committed
+ * @param disp a display created with drm_display_create
+ * @return true if drm_display_commit would flip a new frame
+ */
+bool drm_display_is_present_pending(lv_display_t *disp);
+
+/**
+ * Flip the completed frames of several displays
+ * @param disps displays created with drm_display_create
+ * @param cnt   number of displays
+ * @return the number of displays a flip was committed for
+ * @description displays on the same card are flipped in one atomic
+ * commit. A display whose previous flip hasn't completed yet keeps its
+ * frame for the next call.
+ */
+uint32_t drm_display_commit(lv_display_t *const *disps, uint32_t cnt);
+
+/**
+ * Read the flip statistics
+ * @param disp  a display created with drm_display_create
+ * @param stats receives the statistics
+ * @param reset restart the accumulation after reading
+ */
+void drm_display_get_stats(lv_display_t *disp, drm_display_stats_t *stats, bool reset);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*DRM_DISPLAY_H*/
@@ -0,0 +1,1187 @@
+/**
+ * @file fbdev_display.c
+ *
+ * Legacy framebuffer display driver with zero-copy rendering
+ *
+ * In zero-copy mode the LVGL draw buffer is the mmap'd framebuffer, so
+ * the flush callback has nothing left to do. This is only possible when
+ * the framebuffer layout matches what LVGL renders: same color format,
+ * a stride equal to the display width and no software rotation.
+ * Rotation can still be used if the kernel driver implements it
+ * through fb_var_screeninfo.rotate.
+ *
+ * Note that blending reads back from the draw buffer, so zero-copy only
+ * pays off when the framebuffer is mapped cacheable, which is the case
+ * for most framebuffers allocated from system memory.
+ *
+ * With page flipping the virtual height is doubled and the two halves
+ * are used as front and back page, switched with FBIOPAN_DISPLAY once a
+ * frame is complete. In zero-copy mode LVGL renders into the back page
+ * and keeps both pages in sync itself. In copy mode the areas flushed
+ * in the previous frame are copied into the back page as well, since
+ * that page still holds the image from two frames ago.
+ *
+ * With deferred present the flip is left to the caller, which can wait
+ * for vsync with FBIO_WAITFORVSYNC and flip several displays within the
+ * same refresh window.
+ *
+ * With an asynchronous flush (copy mode only) LVGL renders into two RAM
+ * buffers and flush_cb only queues the areas. A worker thread copies
+ * them into the framebuffer and calls lv_display_flush_ready once the
+ * last area of a frame is written, so the render thread can go on with
+ * the next frame or another display meanwhile. A new frame is not
+ * copied into a page whose previous frame is still waiting to be
+ * presented.
+ *
+ * Every write into the mapping is recorded per memory page. Deferred-I/O
+ * drivers transfer each page that was written to, so with dirty_rows the
+ * copy compares each row with what the framebuffer already holds and
+ * writes only the span that changed, leaving untouched pages clean. With
+ * sync_damage the written pages are msync'd at the end of the frame,
+ * which makes a deferred-I/O driver transfer them right away. In
+ * zero-copy mode LVGL writes the pages itself, so only the flushed areas
+ * are recorded.
+ *
+ * A regular file can stand in for the device. It is sized from the
+ * configured resolution and color format, and everything that needs an
+ * ioctl (page flipping, vsync, hardware rotation) is unavailable.
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/fb.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "lvgl/lvgl.h"
+#if LV_USE_LINUX_FBDEV
+#include "fbdev_display.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/* Max. number of areas remembered for the page sync in copy mode */
+#define SYNC_AREA_MAX 16
+
+/* Max. number of areas queued for the flush worker */
+#define FLUSH_QUEUE_LEN 32
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/* Areas flushed during one frame */
+typedef struct {
+    lv_area_t areas[SYNC_AREA_MAX];
+    uint32_t cnt;
+    bool overflow;                     /* Too many areas, sync the whole screen */
+} area_list_t;
+
+/* An area waiting to be copied by the flush worker */
+typedef struct {
+    lv_area_t area;
+    uint8_t *px_map;
+    bool last;
+} flush_job_t;
+
+typedef struct {
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;               /* Signalled on every state change */
+    flush_job_t jobs[FLUSH_QUEUE_LEN];
+    uint32_t head;                     /* Next job to copy */
+    uint32_t cnt;                      /* Number of queued jobs */
+    uint32_t frames_in_flight;         /* Queued last areas */
+    bool quit;
+} flush_worker_t;
+
+typedef struct {
+    int fd;
+    struct fb_var_screeninfo vinfo;
+    uint8_t *fbp;                      /* Start of the mapping */
+    size_t fb_size;                    /* Size of the mapping */
+    uint8_t *pages[2];                 /* First visible pixel of each page */
+    uint32_t page_cnt;                 /* 2 if page flipping is active */
+    uint32_t front;                    /* Page being scanned out */
+    uint32_t pending;                  /* Page waiting to be presented */
+    bool present_pending;              /* A completed frame waits for fbdev_display_present */
+    bool deferred_present;             /* Leave the flip to fbdev_display_present */
+    bool vsync_unsupported;            /* FBIO_WAITFORVSYNC failed once */
+    bool flip_vsync_pending;           /* Panned, the old front page is scanned out until the next vsync */
+    bool is_file;                      /* Backed by a regular file instead of a device */
+    area_list_t frame_areas;           /* Areas flushed in the current frame */
+    area_list_t prev_areas;            /* Areas flushed in the previous frame */
+    uint32_t line_length;              /* Framebuffer stride in bytes */
+    uint32_t px_size;                  /* Bytes per pixel */
+    fbdev_display_mode_t mode;         /* Effective mode */
+    void *render_bufs[2];              /* RAM buffers in copy mode */
+    bool render_buf_owned[2];
+    fbdev_display_stats_t stats;
+    uint64_t frame_flush_us;           /* Flush time of the current frame */
+    bool dirty_rows;                   /* Copy only the changed span of each row */
+    bool sync_damage;                  /* msync the written pages at the end of a frame */
+    bool sync_failed;                  /* msync failed once, don't retry */
+    bool track_pages;                  /* Deferred I/O or file backed: record the written pages */
+    uint32_t *written_pages;           /* Memory pages written in the current frame, one bit each */
+    size_t mem_page_size;
+    lv_area_t damage;                  /* Bounding box written in the current frame */
+    bool damaged;
+    fbdev_display_damage_cb_t damage_cb;
+    void *damage_user_data;
+    lv_display_t *disp;
+    flush_worker_t *worker;            /* NULL if flushing synchronously */
+} fbdev_display_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+
+static void flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map);
+static void async_flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map);
+static void flush_wait_cb(lv_display_t *disp);
+static void zero_copy_wait_cb(lv_display_t *disp);
+static void wait_flip(fbdev_display_t *dsc);
+static void flush_area(fbdev_display_t *dsc, const lv_area_t *area, uint8_t *px_map, bool last);
+static bool worker_start(fbdev_display_t *dsc);
+static void worker_stop(fbdev_display_t *dsc);
+static void *worker_thread(void *arg);
+static void present_locked(fbdev_display_t *dsc);
+static bool alloc_render_buf(fbdev_display_t *dsc, uint32_t i, void *buf, size_t buf_size,
+                             uint32_t size);
+static void copy_area(lv_display_t *disp, fbdev_display_t *dsc, uint8_t *page,
+                      const lv_area_t *area, const uint8_t *px_map);
+static void sync_prev_areas(lv_display_t *disp, fbdev_display_t *dsc, uint8_t *page,
+                            const uint8_t *px_map);
+static void area_list_add(area_list_t *list, const lv_area_t *area);
+static void mark_written(fbdev_display_t *dsc, const uint8_t *page, const lv_area_t *fb_area);
+static void mark_span(fbdev_display_t *dsc, const uint8_t *dst, size_t len);
+static void complete_damage(fbdev_display_t *dsc);
+static void sync_written_pages(fbdev_display_t *dsc);
+static bool setup_file(fbdev_display_t *dsc, const fbdev_display_config_t *cfg,
+                       struct fb_fix_screeninfo *finfo);
+static bool setup_pages(fbdev_display_t *dsc, struct fb_fix_screeninfo *finfo);
+static void pan_to(fbdev_display_t *dsc, uint32_t page);
+static void delete_event_cb(lv_event_t *e);
+static lv_color_format_t bpp_to_color_format(uint32_t bits_per_pixel);
+static bool try_hw_rotation(int fd, struct fb_var_screeninfo *vinfo,
+                            lv_display_rotation_t rotation);
+static bool try_color_format(int fd, struct fb_var_screeninfo *vinfo, lv_color_format_t cf);
+static uint64_t now_us(void);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+lv_display_t *fbdev_display_create(const char *path, const fbdev_display_config_t *cfg)
+{
+    struct fb_fix_screeninfo finfo;
+    struct stat st;
+    fbdev_display_t *dsc;
+    lv_display_t *disp;
+    lv_color_format_t cf;
+    lv_display_rotation_t sw_rotation = cfg->rotation;
+    int32_t hor_res;
+    int32_t ver_res;
+    uint32_t buf_size;
+
+    dsc = lv_malloc_zeroed(sizeof(fbdev_display_t));
+    if (dsc == NULL) {
+        return NULL;
+    }
+
+    dsc->fd = open(path, O_RDWR);
+    if (dsc->fd < 0) {
+        LV_LOG_ERROR("Cannot open %s: %s", path, strerror(errno));
+        goto err_free;
+    }
+
+    if (fstat(dsc->fd, &st) == 0 && S_ISREG(st.st_mode)) {
+        if (!setup_file(dsc, cfg, &finfo)) {
+            LV_LOG_ERROR("Cannot use %s as framebuffer, resolution and size needed", path);
+            goto err_close;
+        }
+    } else {
+        if (ioctl(dsc->fd, FBIOGET_VSCREENINFO, &dsc->vinfo) == -1) {
+            LV_LOG_ERROR("Cannot read screen info of %s: %s", path, strerror(errno));
+            goto err_close;
+        }
+
+        /* Changing the depth changes the stride, so the fixed info is read afterwards */
+        if (cfg->color_format != LV_COLOR_FORMAT_UNKNOWN &&
+            cfg->color_format != bpp_to_color_format(dsc->vinfo.bits_per_pixel) &&
+            !try_color_format(dsc->fd, &dsc->vinfo, cfg->color_format)) {
+            LV_LOG_WARN("%s can't switch to %u bpp, keeping %u bpp", path,
+                        lv_color_format_get_bpp(cfg->color_format), dsc->vinfo.bits_per_pixel);
+        }
+
+        if (ioctl(dsc->fd, FBIOGET_FSCREENINFO, &finfo) == -1) {
+            LV_LOG_ERROR("Cannot read screen info of %s: %s", path, strerror(errno));
+            goto err_close;
+        }
+    }
+
+    cf = bpp_to_color_format(dsc->vinfo.bits_per_pixel);
+    if (cf == LV_COLOR_FORMAT_UNKNOWN) {
+        LV_LOG_ERROR("Unsupported color depth %u", dsc->vinfo.bits_per_pixel);
+        goto err_close;
+    }
+
+    dsc->px_size = dsc->vinfo.bits_per_pixel / 8;
+    dsc->page_cnt = 1;
+
+    hor_res = cfg->hor_res ? cfg->hor_res : (int32_t)dsc->vinfo.xres;
+    ver_res = cfg->ver_res ? cfg->ver_res : (int32_t)dsc->vinfo.yres;
+
+    /* The virtual height has to be changed before mapping */
+    if (cfg->page_flip && (dsc->is_file || !setup_pages(dsc, &finfo))) {
+        LV_LOG_WARN("%s has no room for a second page, falling back to copy", path);
+    }
+
+    /* Rendering straight into the only, visible page tears when
+     * flipping was asked for, copying the finished areas is preferred */
+    dsc->mode = FBDEV_DISPLAY_MODE_COPY;
+    if (cfg->mode == FBDEV_DISPLAY_MODE_ZERO_COPY &&
+        (!cfg->page_flip || dsc->page_cnt == 2) &&
+        (uint32_t)ver_res <= dsc->vinfo.yres &&
+        finfo.line_length == (uint32_t)hor_res * dsc->px_size) {
+        /* Rendering into the framebuffer can't rotate, let the driver do it.
+         * Rotating may change the stride and the size, so it's done before mapping */
+        if (sw_rotation == LV_DISPLAY_ROTATION_0) {
+            dsc->mode = FBDEV_DISPLAY_MODE_ZERO_COPY;
+        } else if (try_hw_rotation(dsc->fd, &dsc->vinfo, sw_rotation)) {
+            struct fb_var_screeninfo unrotated = dsc->vinfo;
+
+            if (ioctl(dsc->fd, FBIOGET_FSCREENINFO, &finfo) != -1 &&
+                finfo.line_length == (uint32_t)hor_res * dsc->px_size) {
+                sw_rotation = LV_DISPLAY_ROTATION_0;
+                dsc->mode = FBDEV_DISPLAY_MODE_ZERO_COPY;
+            } else {
+                /* LVGL rotates while copying, the driver must not rotate again */
+                unrotated.rotate = 0;
+                if (ioctl(dsc->fd, FBIOPUT_VSCREENINFO, &unrotated) != -1) {
+                    ioctl(dsc->fd, FBIOGET_VSCREENINFO, &dsc->vinfo);
+                }
+                if (ioctl(dsc->fd, FBIOGET_FSCREENINFO, &finfo) == -1) {
+                    LV_LOG_ERROR("Cannot read screen info of %s: %s", path, strerror(errno));
+                    goto err_close;
+                }
+            }
+        }
+    }
+
+    dsc->line_length = finfo.line_length;
+    dsc->fb_size = finfo.smem_len;
+
+    dsc->fbp = mmap(NULL, dsc->fb_size, PROT_READ | PROT_WRITE, MAP_SHARED, dsc->fd, 0);
+    if (dsc->fbp == MAP_FAILED) {
+        LV_LOG_ERROR("Cannot map %s: %s", path, strerror(errno));
+        goto err_close;
+    }
+
+    /* Only deferred I/O transfers whole pages, elsewhere the bitmap would be scanned for nothing */
+    dsc->mem_page_size = (size_t)sysconf(_SC_PAGESIZE);
+    dsc->track_pages = cfg->sync_damage || dsc->is_file;
+    if (dsc->track_pages) {
+        dsc->written_pages = lv_malloc_zeroed(((dsc->fb_size / dsc->mem_page_size + 1) / 32 + 1) *
+                                              sizeof(uint32_t));
+        if (dsc->written_pages == NULL) {
+            goto err_unmap;
+        }
+    }
+    dsc->dirty_rows = cfg->dirty_rows;
+    dsc->sync_damage = cfg->sync_damage;
+
+    dsc->pages[0] = dsc->fbp + dsc->vinfo.xoffset * dsc->px_size;
+    if (dsc->page_cnt == 2) {
+        dsc->pages[1] = dsc->pages[0] + dsc->vinfo.yres * dsc->line_length;
+        pan_to(dsc, 0);
+    } else {
+        dsc->pages[0] += dsc->vinfo.yoffset * dsc->line_length;
+        dsc->pages[1] = dsc->pages[0];
+    }
+
+    disp = lv_display_create(hor_res, ver_res);
+    if (disp == NULL) {
+        goto err_unmap;
+    }
+
+    dsc->disp = disp;
+    lv_display_set_driver_data(disp, dsc);
+    lv_display_set_color_format(disp, cf);
+    lv_display_set_rotation(disp, sw_rotation);
+    lv_display_set_flush_cb(disp, flush_cb);
+    lv_display_add_event_cb(disp, delete_event_cb, LV_EVENT_DELETE, NULL);
+
+    buf_size = hor_res * ver_res * dsc->px_size;
+    if (dsc->mode == FBDEV_DISPLAY_MODE_ZERO_COPY) {
+        /* Start on the back page, the front one is being scanned out */
+        lv_display_set_buffers(disp, dsc->pages[1],
+                               dsc->page_cnt == 2 ? dsc->pages[0] : NULL,
+                               buf_size, LV_DISPLAY_RENDER_MODE_DIRECT);
+        if (dsc->page_cnt == 2) {
+            lv_display_set_flush_wait_cb(disp, zero_copy_wait_cb);
+        }
+        return disp;
+    }
+
+    if (!alloc_render_buf(dsc, 0, cfg->buf, cfg->buf_size, buf_size)) {
+        lv_display_delete(disp);
+        return NULL;
+    }
+
+    /* The worker copies one buffer while LVGL renders into the other */
+    if (cfg->async_flush) {
+        if (alloc_render_buf(dsc, 1, NULL, 0, buf_size) && worker_start(dsc)) {
+            lv_display_set_flush_cb(disp, async_flush_cb);
+            lv_display_set_flush_wait_cb(disp, flush_wait_cb);
+        } else {
+            LV_LOG_WARN("Cannot start the flush worker of %s, flushing synchronously", path);
+        }
+    }
+
+    lv_display_set_buffers(disp, dsc->render_bufs[0], dsc->worker ? dsc->render_bufs[1] : NULL,
+                           buf_size, LV_DISPLAY_RENDER_MODE_DIRECT);
+
+    return disp;
+
+err_unmap:
+    lv_free(dsc->written_pages);
+    munmap(dsc->fbp, dsc->fb_size);
+err_close:
+    close(dsc->fd);
+err_free:
+    lv_free(dsc);
+    return NULL;
+}
+
+fbdev_display_mode_t fbdev_display_get_mode(lv_display_t *disp)
+{
+    fbdev_display_t *dsc = lv_display_get_driver_data(disp);
+
+    return dsc->mode;
+}
+
+uint32_t fbdev_display_get_page_cnt(lv_display_t *disp)
+{
+    fbdev_display_t *dsc = lv_display_get_driver_data(disp);
+
+    return dsc->page_cnt;
+}
+
+uint32_t fbdev_display_get_refresh_period_us(lv_display_t *disp)
+{
+    fbdev_display_t *dsc = lv_display_get_driver_data(disp);
+    const struct fb_var_screeninfo *v = &dsc->vinfo;
+    uint64_t htotal = v->xres + v->left_margin + v->right_margin + v->hsync_len;
+    uint64_t vtotal = v->yres + v->upper_margin + v->lower_margin + v->vsync_len;
+
+    /* pixclock is in picoseconds, SPI panels usually leave it at 0 */
+    return (uint32_t)(v->pixclock * htotal * vtotal / 1000000);
+}
+
+void fbdev_display_set_deferred_present(lv_display_t *disp, bool en)
+{
+    fbdev_display_t *dsc = lv_display_get_driver_data(disp);
+
+    dsc->deferred_present = en;
+    if (!en) {
+        fbdev_display_present(disp);
+    }
+}
+
+bool fbdev_display_present(lv_display_t *disp)
+{
+    fbdev_display_t *dsc = lv_display_get_driver_data(disp);
+    bool presented;
+
+    if (dsc->worker == NULL) {
+        presented = dsc->present_pending;
+        present_locked(dsc);
+        return presented;
+    }
+
+    /* A frame still being copied is waited for, not skipped */
+    pthread_mutex_lock(&dsc->worker->lock);
+    while (dsc->worker->frames_in_flight > 0 && !dsc->present_pending) {
+        pthread_cond_wait(&dsc->worker->cond, &dsc->worker->lock);
+    }
+    presented = dsc->present_pending;
+    present_locked(dsc);
+    pthread_cond_broadcast(&dsc->worker->cond);
+    pthread_mutex_unlock(&dsc->worker->lock);
+
+    return presented;
+}
+
+bool fbdev_display_is_present_pending(lv_display_t *disp)
+{
+    fbdev_display_t *dsc = lv_display_get_driver_data(disp);
+    bool pending;
+
+    if (dsc->worker == NULL) {
+        return dsc->present_pending;
+    }
+
+    pthread_mutex_lock(&dsc->worker->lock);
+    pending = dsc->present_pending || dsc->worker->frames_in_flight > 0;
+    pthread_mutex_unlock(&dsc->worker->lock);
+
+    return pending;
+}
+
+bool fbdev_display_wait_vsync(lv_display_t *disp)
+{
+    fbdev_display_t *dsc = lv_display_get_driver_data(disp);
+    uint32_t crtc = 0;
+
+    if (dsc->vsync_unsupported) {
+        return false;
+    }
+
+    if (ioctl(dsc->fd, FBIO_WAITFORVSYNC, &crtc) == -1) {
+        if (errno != EINTR) {
+            LV_LOG_WARN("FBIO_WAITFORVSYNC not supported: %s", strerror(errno));
+            dsc->vsync_unsupported = true;
+        }
+        return false;
+    }
+    return true;
+}
+
+void fbdev_display_get_stats(lv_display_t *disp, fbdev_display_stats_t *stats, bool reset)
+{
+    fbdev_display_t *dsc = lv_display_get_driver_data(disp);
+
+    if (dsc->worker) {
+        pthread_mutex_lock(&dsc->worker->lock);
+    }
+    *stats = dsc->stats;
+    if (reset) {
+        memset(&dsc->stats, 0, sizeof(dsc->stats));
+    }
+    if (dsc->worker) {
+        pthread_mutex_unlock(&dsc->worker->lock);
+    }
+}
+
+void fbdev_display_set_damage_cb(lv_display_t *disp, fbdev_display_damage_cb_t cb, void *user_data)
+{
+    fbdev_display_t *dsc = lv_display_get_driver_data(disp);
+
+    if (dsc->worker) {
+        pthread_mutex_lock(&dsc->worker->lock);
+    }
+    dsc->damage_cb = cb;
+    dsc->damage_user_data = user_data;
+    if (dsc->worker) {
+        pthread_mutex_unlock(&dsc->worker->lock);
+    }
+}
+
+bool fbdev_display_is_async_flush(lv_display_t *disp)
+{
+    fbdev_display_t *dsc = lv_display_get_driver_data(disp);
+
+    return dsc->worker != NULL;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Flush a rendered area
+ * @description in zero-copy mode the pixels are already in place,
+ * with page flipping the back page is shown once the frame is complete
+ * (or later by fbdev_display_present in deferred mode).
+ * When rendering into flipped pages the last area stays in flight,
+ * zero_copy_wait_cb releases it once the flip has happened.
+ */
+static void flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map)
+{
+    fbdev_display_t *dsc = lv_display_get_driver_data(disp);
+    bool last = lv_display_flush_is_last(disp);
+
+    flush_area(dsc, area, px_map, last);
+    if (!last || dsc->mode != FBDEV_DISPLAY_MODE_ZERO_COPY || dsc->page_cnt != 2) {
+        lv_display_flush_ready(disp);
+    }
+}
+
+/**
+ * Queue a rendered area for the flush worker
+ * @description areas of an unfinished frame are released right away,
+ * LVGL keeps rendering into the same buffer at other coordinates.
+ * The last area is released by the worker once the frame is copied.
+ * The worker doesn't touch the back page while a completed frame waits for
+ * fbdev_display_present(), so a full queue is drained by showing that frame
+ * now instead of waiting for a present only this thread could do.
+ */
+static void async_flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map)
+{
+    fbdev_display_t *dsc = lv_display_get_driver_data(disp);
+    flush_worker_t *w = dsc->worker;
+    bool last = lv_display_flush_is_last(disp);
+    flush_job_t *job;
+
+    pthread_mutex_lock(&w->lock);
+    while (w->cnt == FLUSH_QUEUE_LEN) {
+        if (dsc->present_pending) {
+            present_locked(dsc);
+            dsc->stats.early_present_cnt++;
+            pthread_cond_broadcast(&w->cond);
+        } else {
+            pthread_cond_wait(&w->cond, &w->lock);
+        }
+    }
+
+    job = &w->jobs[(w->head + w->cnt) % FLUSH_QUEUE_LEN];
+    job->area = *area;
+    job->px_map = px_map;
+    job->last = last;
+    w->cnt++;
+    if (last) {
+        w->frames_in_flight++;
+    }
+
+    dsc->stats.queue_depth_total += w->cnt;
+    if (w->cnt > dsc->stats.queue_depth_max) {
+        dsc->stats.queue_depth_max = w->cnt;
+    }
+
+    pthread_cond_broadcast(&w->cond);
+    pthread_mutex_unlock(&w->lock);
+
+    if (!last) {
+        lv_display_flush_ready(disp);
+    }
+}
+
+/**
+ * Called by LVGL before rendering into the page that was shown last
+ * @description LVGL alternates between the two pages. The one it renders into
+ * next was the front page until the last pan, which takes effect at vsync.
+ * A frame still waiting for fbdev_display_present is shown now, as the render
+ * thread can't present while it is blocked here.
+ */
+static void zero_copy_wait_cb(lv_display_t *disp)
+{
+    fbdev_display_t *dsc = lv_display_get_driver_data(disp);
+
+    if (dsc->present_pending) {
+        present_locked(dsc);
+        dsc->stats.early_present_cnt++;
+    }
+    wait_flip(dsc);
+}
+
+/**
+ * Wait for the vsync that completes the last pan, if it hasn't been waited for
+ */
+static void wait_flip(fbdev_display_t *dsc)
+{
+    bool pending;
+
+    if (dsc->worker) {
+        pthread_mutex_lock(&dsc->worker->lock);
+    }
+    pending = dsc->flip_vsync_pending;
+    dsc->flip_vsync_pending = false;
+    if (dsc->worker) {
+        pthread_mutex_unlock(&dsc->worker->lock);
+    }
+
+    if (pending) {
+        fbdev_display_wait_vsync(dsc->disp);
+    }
+}
+
+/**
+ * Called by LVGL before reusing a buffer while the last frame is flushed
+ */
+static void flush_wait_cb(lv_display_t *disp)
+{
+    fbdev_display_t *dsc = lv_display_get_driver_data(disp);
+    flush_worker_t *w = dsc->worker;
+
+    pthread_mutex_lock(&w->lock);
+    while (w->frames_in_flight > 0) {
+        pthread_cond_wait(&w->cond, &w->lock);
+    }
+    pthread_mutex_unlock(&w->lock);
+}
+
+/**
+ * Write an area into the back page and complete the frame on the last one
+ * @description with a worker this runs on the worker thread,
+ * the lock is only taken to publish the completed frame
+ */
+static void flush_area(fbdev_display_t *dsc, const lv_area_t *area, uint8_t *px_map, bool last)
+{
+    lv_display_t *disp = dsc->disp;
+    uint64_t start = now_us();
+    uint32_t back = dsc->page_cnt == 2 ? !dsc->front : dsc->front;
+
+    if (dsc->mode == FBDEV_DISPLAY_MODE_COPY) {
+        if (dsc->page_cnt == 2) {
+            /* The back page was the front one until the last pan */
+            wait_flip(dsc);
+        }
+        copy_area(disp, dsc, dsc->pages[back], area, px_map);
+        if (dsc->page_cnt == 2) {
+            area_list_add(&dsc->frame_areas, area);
+            if (last) {
+                sync_prev_areas(disp, dsc, dsc->pages[back], px_map);
+            }
+        }
+    } else {
+        if (dsc->page_cnt == 2) {
+            /* LVGL alternates between the pages, show the one just rendered */
+            back = (px_map == dsc->pages[0]) ? 0 : 1;
+        }
+        mark_written(dsc, px_map, area);
+    }
+
+    if (last) {
+        complete_damage(dsc);
+    }
+
+    if (dsc->worker) {
+        pthread_mutex_lock(&dsc->worker->lock);
+    }
+
+    if (last) {
+        dsc->pending = back;
+        dsc->present_pending = true;
+        if (!dsc->deferred_present) {
+            present_locked(dsc);
+        }
+    }
+
+    dsc->frame_flush_us += now_us() - start;
+    dsc->stats.flush_cnt++;
+
+    if (last) {
+        dsc->stats.frame_cnt++;
+        dsc->stats.flush_time_us += dsc->frame_flush_us;
+        if (dsc->frame_flush_us > dsc->stats.flush_time_max_us) {
+            dsc->stats.flush_time_max_us = (uint32_t)dsc->frame_flush_us;
+        }
+        dsc->frame_flush_us = 0;
+    }
+
+    if (dsc->worker) {
+        pthread_mutex_unlock(&dsc->worker->lock);
+    }
+}
+
+/**
+ * Flip to the completed frame, with a worker the lock has to be held
+ */
+static void present_locked(fbdev_display_t *dsc)
+{
+    if (!dsc->present_pending) {
+        return;
+    }
+
+    dsc->present_pending = false;
+    if (dsc->page_cnt == 2) {
+        pan_to(dsc, dsc->pending);
+        dsc->stats.flip_cnt++;
+    }
+}
+
+static void *worker_thread(void *arg)
+{
+    fbdev_display_t *dsc = arg;
+    flush_worker_t *w = dsc->worker;
+    flush_job_t job;
+
+    pthread_mutex_lock(&w->lock);
+    while (true) {
+        /* Don't overwrite the back page before its frame has been shown */
+        while (!w->quit && (w->cnt == 0 || dsc->present_pending)) {
+            pthread_cond_wait(&w->cond, &w->lock);
+        }
+        if (w->quit) {
+            break;
+        }
+
+        job = w->jobs[w->head];
+        pthread_mutex_unlock(&w->lock);
+
+        flush_area(dsc, &job.area, job.px_map, job.last);
+
+        pthread_mutex_lock(&w->lock);
+        w->head = (w->head + 1) % FLUSH_QUEUE_LEN;
+        w->cnt--;
+        if (job.last) {
+            w->frames_in_flight--;
+            lv_display_flush_ready(dsc->disp);
+        }
+        pthread_cond_broadcast(&w->cond);
+    }
+    pthread_mutex_unlock(&w->lock);
+
+    return NULL;
+}
+
+static bool worker_start(fbdev_display_t *dsc)
+{
+    flush_worker_t *w = lv_malloc_zeroed(sizeof(flush_worker_t));
+
+    if (w == NULL) {
+        return false;
+    }
+
+    pthread_mutex_init(&w->lock, NULL);
+    pthread_cond_init(&w->cond, NULL);
+    dsc->worker = w;
+
+    if (pthread_create(&w->thread, NULL, worker_thread, dsc) != 0) {
+        pthread_cond_destroy(&w->cond);
+        pthread_mutex_destroy(&w->lock);
+        lv_free(w);
+        dsc->worker = NULL;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Finish the queued areas and stop the worker
+ */
+static void worker_stop(fbdev_display_t *dsc)
+{
+    flush_worker_t *w = dsc->worker;
+
+    pthread_mutex_lock(&w->lock);
+    dsc->deferred_present = false;
+    present_locked(dsc);
+    pthread_cond_broadcast(&w->cond);
+    while (w->cnt > 0) {
+        pthread_cond_wait(&w->cond, &w->lock);
+        present_locked(dsc);
+    }
+    w->quit = true;
+    pthread_cond_broadcast(&w->cond);
+    pthread_mutex_unlock(&w->lock);
+
+    pthread_join(w->thread, NULL);
+    pthread_cond_destroy(&w->cond);
+    pthread_mutex_destroy(&w->lock);
+    lv_free(w);
+    dsc->worker = NULL;
+}
+
+static bool alloc_render_buf(fbdev_display_t *dsc, uint32_t i, void *buf, size_t buf_size,
+                             uint32_t size)
+{
+    if (buf != NULL && buf_size >= size) {
+        dsc->render_bufs[i] = buf;
+        return true;
+    }
+
+    dsc->render_bufs[i] = lv_malloc(size);
+    dsc->render_buf_owned[i] = true;
+    return dsc->render_bufs[i] != NULL;
+}
+
+/**
+ * Copy (and rotate if needed) an area of the full-screen render buffer
+ * into a framebuffer page
+ */
+static void copy_area(lv_display_t *disp, fbdev_display_t *dsc, uint8_t *page,
+                      const lv_area_t *area, const uint8_t *px_map)
+{
+    lv_color_format_t cf = lv_display_get_color_format(disp);
+    lv_display_rotation_t rotation = lv_display_get_rotation(disp);
+    uint32_t src_stride = lv_draw_buf_width_to_stride(lv_display_get_horizontal_resolution(disp), cf);
+    int32_t w = lv_area_get_width(area);
+    int32_t h = lv_area_get_height(area);
+    const uint8_t *src = px_map + area->y1 * src_stride + area->x1 * dsc->px_size;
+    lv_area_t fb_area = *area;
+    uint32_t row_size = w * dsc->px_size;
+    uint32_t start;
+    uint32_t end;
+    lv_area_t row_area;
+    uint8_t *dst;
+    int32_t y;
+
+    if (rotation != LV_DISPLAY_ROTATION_0) {
+        lv_display_rotate_area(disp, &fb_area);
+        dst = page + fb_area.y1 * dsc->line_length + fb_area.x1 * dsc->px_size;
+        lv_draw_sw_rotate(src, dst, w, h, src_stride, dsc->line_length, rotation, cf);
+        mark_written(dsc, page, &fb_area);
+        dsc->stats.bytes_written += (uint64_t)w * h * dsc->px_size;
+        return;
+    }
+
+    dst = page + fb_area.y1 * dsc->line_length + fb_area.x1 * dsc->px_size;
+    for (y = 0; y < h; y++, dst += dsc->line_length, src += src_stride) {
+        start = 0;
+        end = row_size;
+        if (dsc->dirty_rows) {
+            /* Reading doesn't dirty a page, only the changed pixels are written */
+            if (memcmp(dst, src, row_size) == 0) {
+                dsc->stats.bytes_skipped += row_size;
+                continue;
+            }
+            while (dst[start] == src[start]) {
+                start++;
+            }
+            while (dst[end - 1] == src[end - 1]) {
+                end--;
+            }
+            start -= start % dsc->px_size;
+            end += (dsc->px_size - end % dsc->px_size) % dsc->px_size;
+            dsc->stats.bytes_skipped += row_size - (end - start);
+        }
+
+        memcpy(dst + start, src + start, end - start);
+        mark_span(dsc, dst + start, end - start);
+        dsc->stats.bytes_written += end - start;
+
+        lv_area_set(&row_area, fb_area.x1 + start / dsc->px_size, fb_area.y1 + y,
+                    fb_area.x1 + end / dsc->px_size - 1, fb_area.y1 + y);
+        if (dsc->damaged) {
+            lv_area_join(&dsc->damage, &dsc->damage, &row_area);
+        } else {
+            dsc->damage = row_area;
+            dsc->damaged = true;
+        }
+    }
+}
+
+/**
+ * Bring the back page up to date with what the previous frame
+ * wrote to the other page, then remember this frame's areas
+ */
+static void sync_prev_areas(lv_display_t *disp, fbdev_display_t *dsc, uint8_t *page,
+                            const uint8_t *px_map)
+{
+    lv_area_t full;
+    uint32_t i;
+
+    if (dsc->prev_areas.overflow) {
+        lv_area_set(&full, 0, 0, lv_display_get_horizontal_resolution(disp) - 1,
+                    lv_display_get_vertical_resolution(disp) - 1);
+        copy_area(disp, dsc, page, &full, px_map);
+    } else {
+        for (i = 0; i < dsc->prev_areas.cnt; i++) {
+            copy_area(disp, dsc, page, &dsc->prev_areas.areas[i], px_map);
+        }
+    }
+
+    dsc->prev_areas = dsc->frame_areas;
+    dsc->frame_areas.cnt = 0;
+    dsc->frame_areas.overflow = false;
+}
+
+static void area_list_add(area_list_t *list, const lv_area_t *area)
+{
+    if (list->cnt == SYNC_AREA_MAX) {
+        list->overflow = true;
+        return;
+    }
+    list->areas[list->cnt++] = *area;
+}
+
+/**
+ * Record that LVGL or the driver wrote an area of a page
+ */
+static void mark_written(fbdev_display_t *dsc, const uint8_t *page, const lv_area_t *fb_area)
+{
+    uint32_t row_size = lv_area_get_width(fb_area) * dsc->px_size;
+    const uint8_t *dst = page + fb_area->y1 * dsc->line_length + fb_area->x1 * dsc->px_size;
+    int32_t y;
+
+    if (dsc->track_pages) {
+        for (y = fb_area->y1; y <= fb_area->y2; y++, dst += dsc->line_length) {
+            mark_span(dsc, dst, row_size);
+        }
+    }
+
+    if (dsc->damaged) {
+        lv_area_join(&dsc->damage, &dsc->damage, fb_area);
+    } else {
+        dsc->damage = *fb_area;
+        dsc->damaged = true;
+    }
+}
+
+static void mark_span(fbdev_display_t *dsc, const uint8_t *dst, size_t len)
+{
+    size_t first = (size_t)(dst - dsc->fbp) / dsc->mem_page_size;
+    size_t last = (size_t)(dst + len - 1 - dsc->fbp) / dsc->mem_page_size;
+    size_t i;
+
+    if (!dsc->track_pages) {
+        return;
+    }
+
+    for (i = first; i <= last; i++) {
+        dsc->written_pages[i / 32] |= 1u << (i % 32);
+    }
+}
+
+/**
+ * Count and sync the pages written in the frame and report its damage
+ */
+static void complete_damage(fbdev_display_t *dsc)
+{
+    fbdev_display_damage_cb_t damage_cb;
+    void *damage_user_data;
+
+    if (dsc->track_pages) {
+        sync_written_pages(dsc);
+    }
+
+    if (!dsc->damaged) {
+        return;
+    }
+    dsc->damaged = false;
+
+    /* Set from the LVGL thread, this may run on the worker */
+    if (dsc->worker) {
+        pthread_mutex_lock(&dsc->worker->lock);
+    }
+    damage_cb = dsc->damage_cb;
+    damage_user_data = dsc->damage_user_data;
+    if (dsc->worker) {
+        pthread_mutex_unlock(&dsc->worker->lock);
+    }
+
+    if (damage_cb) {
+        damage_cb(dsc->disp, &dsc->damage, damage_user_data);
+    }
+}
+
+/**
+ * Count the pages written in the frame and msync them for deferred I/O
+ */
+static void sync_written_pages(fbdev_display_t *dsc)
+{
+    size_t words = (dsc->fb_size / dsc->mem_page_size + 1) / 32 + 1;
+    size_t first = SIZE_MAX;
+    size_t last = 0;
+    size_t i;
+
+    for (i = 0; i < words; i++) {
+        uint32_t bits = dsc->written_pages[i];
+        if (bits == 0) {
+            continue;
+        }
+        if (first == SIZE_MAX) {
+            first = i * 32 + __builtin_ctz(bits);
+        }
+        last = i * 32 + 31 - __builtin_clz(bits);
+        dsc->stats.pages_written += __builtin_popcount(bits);
+        dsc->written_pages[i] = 0;
+    }
+
+    if (first == SIZE_MAX) {
+        return;
+    }
+
+    if (dsc->sync_damage && !dsc->sync_failed &&
+        msync(dsc->fbp + first * dsc->mem_page_size,
+              (last - first + 1) * dsc->mem_page_size, MS_SYNC) == -1) {
+        LV_LOG_WARN("msync failed: %s", strerror(errno));
+        dsc->sync_failed = true;
+    }
+}
+
+/**
+ * Describe a regular file of the configured size as a single page framebuffer
+ * @return false if the resolution isn't configured or the file can't be sized
+ */
+static bool setup_file(fbdev_display_t *dsc, const fbdev_display_config_t *cfg,
+                       struct fb_fix_screeninfo *finfo)
+{
+    lv_color_format_t cf = cfg->color_format != LV_COLOR_FORMAT_UNKNOWN ?
+                           cfg->color_format : LV_COLOR_FORMAT_NATIVE;
+    struct stat st;
+
+    if (cfg->hor_res <= 0 || cfg->ver_res <= 0) {
+        return false;
+    }
+
+    memset(&dsc->vinfo, 0, sizeof(dsc->vinfo));
+    memset(finfo, 0, sizeof(*finfo));
+    dsc->vinfo.xres = dsc->vinfo.xres_virtual = cfg->hor_res;
+    dsc->vinfo.yres = dsc->vinfo.yres_virtual = cfg->ver_res;
+    dsc->vinfo.bits_per_pixel = lv_color_format_get_bpp(cf);
+    finfo->line_length = cfg->hor_res * lv_color_format_get_size(cf);
+    finfo->smem_len = finfo->line_length * cfg->ver_res;
+
+    /* No ioctls on a file */
+    dsc->is_file = true;
+    dsc->vsync_unsupported = true;
+
+    if (fstat(dsc->fd, &st) == -1) {
+        return false;
+    }
+    return st.st_size >= (off_t)finfo->smem_len || ftruncate(dsc->fd, finfo->smem_len) == 0;
+}
+
+/**
+ * Double the virtual height to get a second page
+ * @return true if the driver provides two pages
+ */
+static bool setup_pages(fbdev_display_t *dsc, struct fb_fix_screeninfo *finfo)
+{
+    struct fb_var_screeninfo req = dsc->vinfo;
+
+    if (req.yres_virtual < req.yres * 2) {
+        req.yres_virtual = req.yres * 2;
+        if (ioctl(dsc->fd, FBIOPUT_VSCREENINFO, &req) == -1 ||
+            ioctl(dsc->fd, FBIOGET_VSCREENINFO, &req) == -1 ||
+            ioctl(dsc->fd, FBIOGET_FSCREENINFO, finfo) == -1) {
+            return false;
+        }
+    }
+
+    if (req.yres_virtual < req.yres * 2 ||
+        finfo->smem_len < req.yres * 2 * finfo->line_length) {
+        return false;
+    }
+
+    dsc->vinfo = req;
+    dsc->page_cnt = 2;
+    return true;
+}
+
+static void pan_to(fbdev_display_t *dsc, uint32_t page)
+{
+    dsc->vinfo.yoffset = page * dsc->vinfo.yres;
+    if (ioctl(dsc->fd, FBIOPAN_DISPLAY, &dsc->vinfo) == -1) {
+        LV_LOG_WARN("FBIOPAN_DISPLAY failed: %s", strerror(errno));
+    } else {
+        dsc->flip_vsync_pending = true;
+    }
+    dsc->front = page;
+}
+
+static void delete_event_cb(lv_event_t *e)
+{
+    lv_display_t *disp = lv_event_get_target(e);
+    fbdev_display_t *dsc = lv_display_get_driver_data(disp);
+    uint32_t i;
+
+    if (dsc == NULL) {
+        return;
+    }
+
+    if (dsc->worker) {
+        worker_stop(dsc);
+    }
+
+    lv_free(dsc->written_pages);
+    munmap(dsc->fbp, dsc->fb_size);
+    close(dsc->fd);
+    for (i = 0; i < 2; i++) {
+        if (dsc->render_buf_owned[i]) {
+            lv_free(dsc->render_bufs[i]);
+        }
+    }
+    lv_free(dsc);
+    lv_display_set_driver_data(disp, NULL);
+}
+
+static lv_color_format_t bpp_to_color_format(uint32_t bits_per_pixel)
+{
+    switch (bits_per_pixel) {
+    case 16:
+        return LV_COLOR_FORMAT_RGB565;
+    case 24:
+        return LV_COLOR_FORMAT_RGB888;
+    case 32:
+        return LV_COLOR_FORMAT_XRGB8888;
+    default:
+        return LV_COLOR_FORMAT_UNKNOWN;
+    }
+}
+
+/**
+ * Ask the kernel driver to rotate the scan-out
+ * @description FB_ROTATE_CW..FB_ROTATE_CCW use the same clockwise
+ * numbering as lv_display_rotation_t. Most drivers ignore the field,
+ * the read back tells whether the request was honored.
+ */
+static bool try_hw_rotation(int fd, struct fb_var_screeninfo *vinfo,
+                            lv_display_rotation_t rotation)
+{
+    struct fb_var_screeninfo req = *vinfo;
+
+    req.rotate = (uint32_t)rotation;
+    if (ioctl(fd, FBIOPUT_VSCREENINFO, &req) == -1 ||
+        ioctl(fd, FBIOGET_VSCREENINFO, &req) == -1) {
+        return false;
+    }
+
+    if (req.rotate != (uint32_t)rotation) {
+        /* Accepted as something else, go back to the mode the caller knows */
+        ioctl(fd, FBIOPUT_VSCREENINFO, vinfo);
+        return false;
+    }
+
+    *vinfo = req;
+    return true;
+}
+
+/**
+ * Ask the kernel driver for another color depth
+ * @description Only the depth is requested, the driver fills in the
+ * channel layout. The read back tells whether it was accepted.
+ */
+static bool try_color_format(int fd, struct fb_var_screeninfo *vinfo, lv_color_format_t cf)
+{
+    struct fb_var_screeninfo req = *vinfo;
+
+    req.bits_per_pixel = lv_color_format_get_bpp(cf);
+    if (ioctl(fd, FBIOPUT_VSCREENINFO, &req) == -1) {
+        return false;
+    }
+
+    if (ioctl(fd, FBIOGET_VSCREENINFO, &req) == -1 ||
+        bpp_to_color_format(req.bits_per_pixel) != cf) {
+        /* The mode may have changed anyway, go back to the one the caller knows */
+        ioctl(fd, FBIOPUT_VSCREENINFO, vinfo);
+        return false;
+    }
+
+    *vinfo = req;
+    return true;
+}
+
+static uint64_t now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+#endif /*LV_USE_LINUX_FBDEV*/
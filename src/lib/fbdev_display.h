@@ -0,0 +1,190 @@
+/**
+ * @file fbdev_display.h
+ *
+ * Legacy framebuffer display driver with zero-copy rendering
+ *
+ * Unlike lv_linux_fbdev, which always renders into a separate buffer
+ * and copies it into the mapped framebuffer, this driver can hand the
+ * mmap'd framebuffer memory itself to LVGL as the draw buffer.
+ * If that is not possible (software rotation, mismatching stride or
+ * color format) it falls back to rendering into a RAM buffer and
+ * copying only the flushed areas.
+ *
+ * If the driver provides a virtual height of two screens, the two pages
+ * can be flipped with FBIOPAN_DISPLAY so rendering never touches the
+ * page being scanned out.
+ *
+ * The flip can be deferred to the caller, e.g. to wait for vsync and
+ * present several panels in the same refresh window.
+ *
+ * In copy mode the framebuffer writes can be moved to a worker thread,
+ * so the copy of one frame overlaps with rendering the next one.
+ *
+ * For deferred-I/O panels (typically SPI), where every dirtied memory
+ * page is pushed over the bus, the copy can skip pixels that didn't
+ * change, and the written pages can be synced right when the frame is
+ * complete instead of after the driver's delay.
+ *
+ * The path may also be a regular file of the configured size, which is
+ * handy to measure the written bytes without a panel.
+ *
+ */
+
+#ifndef FBDEV_DISPLAY_H
+#define FBDEV_DISPLAY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stddef.h>
+#include <stdint.h>
+
+#include "lvgl/lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/* How the rendered pixels reach the framebuffer */
+typedef enum {
+    FBDEV_DISPLAY_MODE_COPY,      /* Render into a RAM buffer, copy flushed areas */
+    FBDEV_DISPLAY_MODE_ZERO_COPY, /* Render straight into the mmap'd framebuffer */
+} fbdev_display_mode_t;
+
+typedef struct {
+    int32_t hor_res;                   /* 0 to use the panel resolution */
+    int32_t ver_res;                   /* 0 to use the panel resolution */
+    lv_display_rotation_t rotation;    /* Rotation of the panel */
+    lv_color_format_t color_format;    /* Requested depth, LV_COLOR_FORMAT_UNKNOWN to keep the panel's */
+    fbdev_display_mode_t mode;         /* Requested mode, may fall back to copy */
+    bool page_flip;                    /* Use two pages and FBIOPAN_DISPLAY */
+    bool async_flush;                  /* Copy mode: copy on a worker thread */
+    void *buf;                         /* Render buffer for copy mode, NULL to allocate */
+    size_t buf_size;                   /* Size of buf in bytes */
+    bool dirty_rows;                   /* Copy mode: write only the changed span of each row */
+    bool sync_damage;                  /* msync the written pages once a frame is complete */
+} fbdev_display_config_t;
+
+/**
+ * Called once a frame is written with the bounding box of the written
+ * pixels, in framebuffer coordinates. Runs on the flush worker thread
+ * if the asynchronous flush is active.
+ */
+typedef void (*fbdev_display_damage_cb_t)(lv_display_t *disp, const lv_area_t *area, void *user_data);
+
+/* Flush statistics, accumulated since creation or the last reset */
+typedef struct {
+    uint32_t flush_cnt;                /* Number of flushed areas */
+    uint32_t frame_cnt;                /* Number of completed frames */
+    uint64_t flush_time_us;            /* Total time spent in the flush callback */
+    uint32_t flush_time_max_us;        /* Longest single frame flush */
+    uint64_t bytes_written;            /* Bytes copied into the framebuffer */
+    uint64_t bytes_skipped;            /* Bytes not copied because they didn't change */
+    uint64_t pages_written;            /* Memory pages dirtied, what deferred I/O transfers (sync_damage or file only) */
+    uint32_t flip_cnt;                 /* Number of page flips */
+    uint64_t queue_depth_total;        /* Sum of the worker queue depth at each flush */
+    uint32_t queue_depth_max;          /* Deepest worker queue seen */
+    uint32_t early_present_cnt;        /* Deferred frames shown early because the queue filled up */
+} fbdev_display_stats_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Create a display on a framebuffer device
+ * @param path the framebuffer device, e.g. /dev/fb0
+ * @param cfg  the display configuration
+ * @return the LVGL display or NULL on error
+ */
+lv_display_t *fbdev_display_create(const char *path, const fbdev_display_config_t *cfg);
+
+/**
+ * Get the mode that is actually in use
+ * @param disp a display created with fbdev_display_create
+ * @return FBDEV_DISPLAY_MODE_ZERO_COPY if LVGL renders into the framebuffer
+ */
+fbdev_display_mode_t fbdev_display_get_mode(lv_display_t *disp);
+
+/**
+ * Get the number of framebuffer pages in use
+ * @param disp a display created with fbdev_display_create
+ * @return 2 if page flipping is active, 1 otherwise
+ */
+uint32_t fbdev_display_get_page_cnt(lv_display_t *disp);
+
+/**
+ * Get the refresh period of the panel from the video timings
+ * @param disp a display created with fbdev_display_create
+ * @return the period in microseconds, 0 if the driver doesn't report a pixel clock
+ */
+uint32_t fbdev_display_get_refresh_period_us(lv_display_t *disp);
+
+/**
+ * Defer showing completed frames until fbdev_display_present is called
+ * @param disp a display created with fbdev_display_create
+ * @param en   true: defer, false: flip as soon as a frame is flushed
+ */
+void fbdev_display_set_deferred_present(lv_display_t *disp, bool en);
+
+/**
+ * Show the last completed frame
+ * @param disp a display created with fbdev_display_create
+ * @return true if a frame was pending
+ */
+bool fbdev_display_present(lv_display_t *disp);
+
+/**
+ * Check whether a completed frame waits to be presented
+ * @param disp a display created with fbdev_display_create
+ * @return true if fbdev_display_present would show a new frame
+ */
+bool fbdev_display_is_present_pending(lv_display_t *disp);
+
+/**
+ * Block until the next vertical blanking interval
+ * @param disp a display created with fbdev_display_create
+ * @return false if the driver doesn't support FBIO_WAITFORVSYNC
+ */
+bool fbdev_display_wait_vsync(lv_display_t *disp);
+
+/**
+ * Check whether the framebuffer is written by a worker thread
+ * @param disp a display created with fbdev_display_create
+ * @return true if the asynchronous flush is active
+ */
+bool fbdev_display_is_async_flush(lv_display_t *disp);
+
+/**
+ * Set a callback receiving the area written in each frame
+ * @param disp      a display created with fbdev_display_create
+ * @param cb        the callback, e.g. to issue a driver specific damage ioctl, NULL to remove
+ * @param user_data passed to the callback
+ */
+void fbdev_display_set_damage_cb(lv_display_t *disp, fbdev_display_damage_cb_t cb, void *user_data);
+
+/**
+ * Read the flush statistics
+ * @param disp  a display created with fbdev_display_create
+ * @param stats receives the statistics
+ * @param reset restart the accumulation after reading
+ */
+void fbdev_display_get_stats(lv_display_t *disp, fbdev_display_stats_t *stats, bool reset);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*FBDEV_DISPLAY_H*/
@@ -1,4 +1,15 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "eye_bench.h"
 #include "eye_controller.h"
+#include "eye_ctrl_client.h"
+#include "eye_ctrl_server.h"
+#include "eye_gaze_shm.h"
 
 #define LEFT_EYE_GIF "A:/mnt/data/panel/leye_tired.gif"
 #define LEFT_EYELID_GIF "A:/mnt/data/panel/leyelid_tired.gif"
@@ -8,12 +19,129 @@
 #define NEW_LEFT_EYELID_GIF "A:/mnt/data/panel/leyelid_proud.gif"
 #define NEW_RIGHT_EYE_GIF "A:/mnt/data/panel/reye_proud.gif"
 #define NEW_RIGHT_EYELID_GIF "A:/mnt/data/panel/reyelid_proud.gif"
+#define EMOTION_DIR "A:/mnt/data/panel"  // 表情素材目录
+#define EYE_CTRL_SOCKET "/tmp/lvglsim-eyes.sock"
+
+/* lvglsim --ctl "<命令>" [次数]：向运行中的 lvglsim 发送命令，打印往返延迟 */
+static int ctl_run(const char *text, uint32_t cnt) {
+  int fd = eye_ctrl_client_connect(EYE_CTRL_SOCKET);
+  if (fd < 0) {
+    printf("eye ctrl: cannot connect to %s\n", EYE_CTRL_SOCKET);
+    return 1;
+  }
+
+  eye_ctrl_reply_t reply;
+  int64_t rtt_sum = 0, rtt_max = 0;
+  uint64_t server_sum = 0;
+  for (uint32_t i = 0; i < cnt; i++) {
+    int64_t rtt = eye_ctrl_client_request(fd, text, &reply);
+    if (rtt < 0) {
+      printf("eye ctrl: request failed\n");
+      close(fd);
+      return 1;
+    }
+    rtt_sum += rtt;
+    if (rtt > rtt_max) rtt_max = rtt;
+    server_sum += reply.server_us;
+  }
+  close(fd);
+
+  printf("%u applied, status %d, rtt avg %lld us max %lld us, server %llu us\n",
+         reply.applied, reply.status, (long long)(rtt_sum / cnt),
+         (long long)rtt_max, (unsigned long long)(server_sum / cnt));
+  return reply.status ? 1 : 0;
+}
+
+/*
+ * lvglsim --gaze-feed [hz] [秒数]：模拟跟踪器，按固定频率沿圆周写共享内存视线目标，
+ * 打印实际写入频率和每次写入的耗时
+ */
+static int gaze_feed_run(uint32_t hz, uint32_t seconds) {
+  eye_gaze_shm_t *shm = eye_gaze_shm_attach(EYE_GAZE_SHM_NAME);
+  if (!shm) {
+    printf("gaze feed: %s not found, is lvglsim running?\n", EYE_GAZE_SHM_NAME);
+    return 1;
+  }
+
+  uint64_t period_ns = 1000000000ull / hz;
+  uint64_t write_ns = 0;
+  uint32_t cnt = 0;
+  struct timespec next, t0, t1;
+  clock_gettime(CLOCK_MONOTONIC, &next);
+  uint64_t start_us = eye_gaze_shm_now_us();
+
+  // eye_cnt 由 lvglsim 写入，可能被其它进程改坏
+  uint32_t eye_cnt = shm->eye_cnt;
+  if (eye_cnt > EYE_GAZE_SHM_EYES) eye_cnt = EYE_GAZE_SHM_EYES;
+
+  for (uint32_t i = 0; i < hz * seconds; i++) {
+    double angle = i * 2 * M_PI / hz;  // 每秒转一圈
+    int32_t x = (int32_t)lround(cos(angle) * 28);
+    int32_t y = (int32_t)lround(sin(angle) * 28);
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (uint32_t e = 0; e < eye_cnt; e++) {
+      eye_gaze_shm_write(shm, e, x, y);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    write_ns += (uint64_t)(t1.tv_sec - t0.tv_sec) * 1000000000ull +
+                (uint64_t)(t1.tv_nsec - t0.tv_nsec);
+    cnt++;
+
+    uint64_t ns = (uint64_t)next.tv_nsec + period_ns;
+    next.tv_sec += (time_t)(ns / 1000000000ull);
+    next.tv_nsec = (long)(ns % 1000000000ull);
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+  }
+
+  double wall = (eye_gaze_shm_now_us() - start_us) / 1e6;
+  if (cnt > 0) {
+    printf("gaze feed: %u updates x %u eyes, %.1f Hz, %.0f ns per update\n",
+           cnt, eye_cnt, cnt / wall, (double)write_ns / cnt);
+  }
+  eye_gaze_shm_detach(shm);
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  // lvglsim --bench：在内存显示器上跑眼睛渲染基准测试
+  if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+    eye_bench_assets_t assets = {
+        .left_eye_path = LEFT_EYE_GIF,
+        .left_eyelid_path = LEFT_EYELID_GIF,
+        .right_eye_path = RIGHT_EYE_GIF,
+        .right_eyelid_path = RIGHT_EYELID_GIF,
+        .max_offset_px = 28,
+    };
+    return eye_bench_run(&assets);
+  }
+  if (argc > 2 && strcmp(argv[1], "--ctl") == 0) {
+    uint32_t cnt = argc > 3 ? (uint32_t)strtoul(argv[3], NULL, 0) : 1;
+    return ctl_run(argv[2], cnt ? cnt : 1);
+  }
+  if (argc > 1 && strcmp(argv[1], "--gaze-feed") == 0) {
+    uint32_t hz = argc > 2 ? (uint32_t)strtoul(argv[2], NULL, 0) : 120;
+    uint32_t seconds = argc > 3 ? (uint32_t)strtoul(argv[3], NULL, 0) : 10;
+    return gaze_feed_run(hz ? hz : 120, seconds ? seconds : 10);
+  }
 
-int main(void) {
   struct eye_t left_eye, right_eye;
-  eye_controller_init(&left_eye, &right_eye, LEFT_EYE_GIF, LEFT_EYELID_GIF,
-                      LV_DISPLAY_ROTATION_270, RIGHT_EYE_GIF, RIGHT_EYELID_GIF,
-                      LV_DISPLAY_ROTATION_90, 28);
+  if (eye_controller_init(&left_eye, &right_eye, LEFT_EYE_GIF, LEFT_EYELID_GIF,
+                          LV_DISPLAY_ROTATION_270, RIGHT_EYE_GIF,
+                          RIGHT_EYELID_GIF, LV_DISPLAY_ROTATION_90, 28) < 0) {
+    return EXIT_FAILURE;
+  }
+
+  // 其它进程通过 Unix 套接字控制眼睛，见 eye_ctrl_proto.h
+  eye_ctrl_server_config_t ctrl_cfg = {
+      .path = EYE_CTRL_SOCKET,
+      .asset_dir = EMOTION_DIR,
+      .max_offset_px = 28,
+  };
+  eye_ctrl_server_init(&ctrl_cfg);
+
+  // 跟踪器通过共享内存高频输入视线，见 eye_gaze_shm.h
+  eye_controller_open_gaze_shm(EYE_GAZE_SHM_NAME);
 
   // // 传入素材的路径，max_offset_px是限制的最大的偏移像素
   // eye_switch_material(&left_eye, &right_eye, NEW_LEFT_EYE_GIF, NEW_LEFT_EYELID_GIF, 28,